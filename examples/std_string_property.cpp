@@ -26,19 +26,21 @@ namespace cojson {
 namespace details {
 template<>
 bool reader<std::string>::read(std::string& dst, lexer& in) noexcept  {
-	std::string tmp;
+	/* characters are appended to dst directly, without a temporary.
+	 * cojson_stl.hpp provides this reader for any std::basic_string,
+	 * including cojson::string with memory in an arena				*/
 	bool first = true;
 	ctype ct;
 	char chr;
+	dst.clear();
 	while( (ct=in.string(chr, first)) == ctype::string ) {
-		tmp += chr;
+		dst += chr;
 		first = false;
 	}
 	if( chr ) {
 		in.error(error_t::bad);
 		return false;
 	}
-	dst = tmp;
 	return true;
 }
 
@@ -57,7 +57,7 @@ bool writer<const char_t*>::write(char_t chr, ostream& out) noexcept {
 		if( literal::is_escaped(chr) ) {
 			out.put(literal::escape);
 		}
-		return out.put(chr);
+		return out.emit(chr);
 	}
 }
 
@@ -70,6 +70,15 @@ bool writer<const char_t*>::write(const char_t * str, ostream& out) noexcept {
 	return r && out.put(literal::quotation_mark);
 } /* avr: 904 bytes */
 
+bool writer<view>::write(const view& str, ostream& out) noexcept {
+	if( str.null() )
+		return value::null(out);
+	bool r = out.put(literal::quotation_mark);
+	for(const char_t* p = str.begin(); r && p != str.end(); ++p)
+		r = writer<const char_t*>::write(*p, out);
+	return r && out.put(literal::quotation_mark);
+}
+
 bool reader<char_t*>::read(char_t* dst, size_t n, lexer& in) noexcept  {
 	bool first = true;
 	if( dst == nullptr || n == 0 ) {
@@ -199,6 +208,32 @@ bool reader<double>::read(double& val, lexer& in) noexcept {
 	}
 } /* avr: 1010 bytes (+ 700 for float procedures */
 
+const char_t* digits::scan(const char_t* p, const char_t* e,
+		double& dst) noexcept {
+	const char_t* const b = p;
+	/* anything else is left to the generic path to handle			*/
+	if( p == e || ! (isnum(*p) || *p == literal::minus) ) return nullptr;
+	maker<double> maker(dst);
+	for(; p != e; ++p) {
+		bool r;
+		switch( *p ) {
+		case literal::minus:	r = maker.minus(); break;
+		case literal::plus:		r = maker.plus(); break;
+		case literal::decimal:	r = maker.dot(); break;
+		case 'e': case 'E':		r = maker.e(); break;
+		case literal::value_separator:
+		case literal::end_array:
+		case literal::ws: case '\n': case '\r': case '\t':
+			return p != b && maker.done() ? p : nullptr;
+		default:
+			if( ! isnum(*p) ) return nullptr;
+			r = maker.digit(*p - literal::digit0);
+		}
+		if( ! r ) return nullptr;
+	}
+	return nullptr;
+}
+
 }
 /******************************************************************************/
 namespace details {
@@ -238,7 +273,7 @@ private:
 }; /* avr: 20 bytes */
 
 bool lexer::skip(bool list) noexcept {
-if( config::config::mismatch != config::config::mismatch_is::error ) {
+if( rules().mismatch != config::mismatch_is::error ) {
 	bstack stack;
 	char_t chr;
 	ctype ct;
@@ -313,8 +348,49 @@ if( config::config::mismatch != config::config::mismatch_is::error ) {
 	return false;
 } /* avr: 102 bytes */
 
+size_t lexer::extent() const noexcept {
+	if( blocked || hold ) return 0;
+	const char_t* p = stream.gnext;
+	const char_t* const e = stream.gend;
+	while( p != e && isws(*p) ) ++p;
+	if( p == e || *p != literal::begin_array ) return 0;
+	size_t n = 0, level = 0;
+	bool empty = true, quoted = false;
+	for(++p; p != e; ++p) {
+		if( quoted ) {
+			if( *p == literal::escape ) {
+				if( ++p == e ) break;
+			} else if( *p == literal::quotation_mark )
+				quoted = false;
+			continue;
+		}
+		switch( *p ) {
+		case literal::quotation_mark:
+			quoted = true;
+			break;
+		case literal::begin_array:
+		case literal::begin_object:
+			++level;
+			break;
+		case literal::end_object:
+			--level;
+			break;
+		case literal::end_array:
+			if( level-- == 0 ) return empty ? 0 : n + 1;
+			break;
+		case literal::value_separator:
+			if( level == 0 ) ++n;
+			break;
+		default:
+			if( isws(*p) ) continue;
+		}
+		empty = false;
+	}
+	return 0;
+}
+
 bool lexer::skip_string(bool first) noexcept {
-	if( config::config::mismatch == config::config::mismatch_is::error )
+	if( rules().mismatch == config::mismatch_is::error )
 		return false;
 	else {
 		char_t chr;
@@ -329,20 +405,16 @@ bool lexer::skip_member(bool first) noexcept {
 		skip_string(first) && skipws(chr) && chr == literal::name_separator;
 }
 
-static inline bool readable(const istream & in) noexcept {
-	return error_t::noerror == (in.error() &
-	  ((config::mismatch == config::mismatch_is::error) ?
-		error_t::blocked : error_t::failed));
-}
-
 ctype lexer::get(char_t& chr) noexcept {
-	if( ! readable(stream) ) return ctype::err;
+	/* re-checked while blocked, the stream may have been cleared			*/
+	if( blocked && (blocked = ! readable(stream)) ) return ctype::err;
 	if( hold ) {
 		chr = hold;
 		hold = 0;
 		return chartype(chr);
 	} else {
-		if( ! stream.get(chr) ) {
+		if( ! stream.next(chr) ) {
+			blocked = ! readable(stream);
 			return bad(chr);
 		}
 	}
@@ -421,12 +493,139 @@ ctype lexer::string(char_t& chr, bool first) noexcept {
 	}
 } /* avr: 270 bytes (with unescape & unhex) */
 
+const char_t** pool::slot(unsigned long h, const view& str) const noexcept {
+	for(size_t n = 0, i = h & mask; n <= mask; ++n, i = (i + 1) & mask)
+		if( table[i] == nullptr || str == table[i] )
+			return table + i;
+	return nullptr;
+}
+
+symbol pool::take() noexcept {
+	const char_t** at = slot(hash, chars.pending());
+	if( at == nullptr ) {
+		drop();
+		return symbol();
+	}
+	if( *at ) {
+		drop();
+		return symbol(*at);
+	}
+	hash = basis;
+	if( (*at = chars.take().data()) != nullptr ) ++count;
+	return symbol(*at);
+}
+
+symbol pool::find(const char_t* str) const noexcept {
+	unsigned long h = basis;
+	size_t n = 0;
+	while( str[n] ) h = mix(h, str[n++]);
+	const char_t** at = slot(h, view(str, n));
+	return at ? symbol(*at) : symbol();
+}
+
+bool pool::read(symbol& dst, lexer& in) noexcept {
+	ctype ct;
+	if( ! isvalid(ct=in.value(ctype::stringnull)) )
+		return in.skip();
+	dst = symbol();
+	if( ct == ctype::null ) return true;
+	bool first = true;
+	bool fits = true;
+	char_t chr;
+	while( (ct=in.string(chr, first)) == ctype::string ) {
+		fits = fits && put(chr);
+		first = false;
+	}
+	if( ct != ctype::delim ) {
+		drop();
+		return false;
+	}
+	if( fits ) dst = take();
+	else drop();
+	if( dst.null() ) in.error(error_t::overrun);
+	return true;
+}
+
+bool lexer::plain(view& dst) noexcept {
+	if( blocked || hold ) return false;
+	for(const char_t* p = stream.gnext; p != stream.gend; ++p) {
+		if( *p == literal::quotation_mark ) {
+			dst = view(stream.gnext, static_cast<size_t>(p - stream.gnext));
+			stream.gnext = p + 1;
+			return true;
+		}
+		if( *p == literal::escape ) return false;
+	}
+	return false;
+}
+
+size_t lexer::remainder() const noexcept {
+	if( blocked || (hold && hold != literal::quotation_mark) ) return 0;
+	for(const char_t* p = stream.gnext; p != stream.gend; ++p) {
+		if( *p == literal::quotation_mark )
+			return static_cast<size_t>(p - stream.gnext);
+		if( *p == literal::escape && ++p == stream.gend ) break;
+	}
+	return 0;
+}
+
+bool lexer::string(view& dst) noexcept {
+	char_t chr;
+	dst = view();
+	if( ! skipws(chr) || chr != literal::quotation_mark ) {
+		bad(chr);
+		return false;
+	}
+	const char_t* const begin = stream.gnext;
+	char_t* const out = stream.gwritable ? const_cast<char_t*>(begin) : nullptr;
+	size_t n = 0;
+	bool pending = false;
+	ctype ct;
+	while( stream.gnext != stream.gend ) {
+		const char_t* pos = stream.gnext;
+		if( (ct=string(chr, false)) != ctype::string ) {
+			if( ct != ctype::delim ) return false;
+			dst = view(begin, n);
+			return true;
+		}
+		/* decoded character is never longer than its escape sequence,
+		 * so writing never overtakes reading 							*/
+		if( out ) out[n] = chr;
+		else if( stream.gnext != pos + 1 ) {
+			pending = true;
+			break;
+		}
+		++n;
+	}
+	/* string does not fit the window or needs decoding in constant one */
+	if( heap == nullptr ) {
+		error(error_t::noobject);
+		return skip_string(false);
+	}
+	bool fits = true;
+	for(size_t i = 0; i < n && fits; ++i) fits = heap->put(begin[i]);
+	if( pending && fits ) fits = heap->put(chr);
+	while( fits && (ct=string(chr, false)) == ctype::string )
+		fits = heap->put(chr);
+	if( ! fits ) {
+		heap->drop();
+		error(error_t::overrun);
+		return skip_string(false);
+	}
+	if( ct != ctype::delim ) {
+		heap->drop();
+		return false;
+	}
+	dst = heap->take();
+	return true;
+}
+
 bool lexer::member(char_t*& dst) noexcept {
 	char_t chr;
 	if( ! skipws(chr) ) { bad(chr); return false; }
 	if( chr != literal::quotation_mark ) { bad(chr); return false; }
 	back(chr);
-	if( reader<char_t*>::read(name, name.size, *this) ) {
+	if( reader<char_t*>::read(name, namesize, *this) ) {
 		if( ! skipws(chr) ) { bad(chr); return false; }
 		if( chr == literal::name_separator ) {
 			dst = name;
@@ -512,17 +711,195 @@ bool value::null(ostream& out) noexcept {
 }
 
 bool ostream::puts(const char_t* s) noexcept {
-	while( *s && put(*s++));
+	while( *s && emit(*s++));
 	return *s == 0;
 }
 
+bool ostream::write(const char_t* s, size_t n) noexcept {
+	while( n && emit(*s++) ) --n;
+	return n == 0;
+}
+
+bool composer::put(char_t c) noexcept {
+	if( length >= maxtext ) {
+		error(error_t::overrun);
+		return false;
+	}
+	text[length++] = c;
+	return true;
+}
+
+bool composer::write(const char_t* s, size_t n) noexcept {
+	if( n > maxtext - length ) {
+		error(error_t::overrun);
+		return false;
+	}
+	while( n-- ) text[length++] = *s++;
+	return true;
+}
+
+bool composer::value(writer_f w, const void* item, const void* val) noexcept {
+	if( count >= maxsteps ) {
+		error(error_t::overrun);
+		return false;
+	}
+	steps[count].end = length;
+	steps[count].write = w;
+	steps[count].item = item;
+	steps[count].offset = static_cast<const char*>(val) - origin;
+	++count;
+	return true;
+}
+
+bool composer::begin(const void* obj) noexcept {
+	clear();
+	count = length = 0;
+	origin = static_cast<const char*>(obj);
+	return true;
+}
+
+bool composer::end(bool success) noexcept {
+	state = success && isgood() ? state_t::ready : state_t::failed;
+	return compiled();
+}
+
+bool composer::run(const void* obj, ostream& out) const noexcept {
+	const char* base = static_cast<const char*>(obj);
+	size_t pos = 0;
+	for(size_t i = 0; i < count; ++i) {
+		if( ( steps[i].end > pos && ! out.write(text+pos, steps[i].end-pos) )
+		   || ! steps[i].write(steps[i].item, base+steps[i].offset, out) )
+			return false;
+		pos = steps[i].end;
+	}
+	return out.write(text+pos, length-pos);
+}
+
+namespace {
+/** array agent for a member described with a descriptor 					*/
+struct items {
+	const descriptor& d;
+	static inline constexpr bool null(char*) noexcept {
+		return not config::null_is_error;
+	}
+	inline bool read(char* dst, lexer& in, size_t i) const noexcept {
+		return
+			( schema::read(d, d.item, dst + i * d.stride, in) || in.skip(false) )?
+			(i < d.count - 1) : false;
+	}
+	inline bool write(const char* src, ostream& out, size_t i) const noexcept {
+		schema::write(d, d.item, src + i * d.stride, out);
+		return i < d.count - 1;
+	}
+};
+
+template<typename T>
+static inline T& as(char* p) noexcept {
+	return *reinterpret_cast<T*>(p);
+}
+
+template<typename T>
+static inline const T& as(const char* p) noexcept {
+	return *reinterpret_cast<const T*>(p);
+}
+}
+
+bool schema::read(void* obj, lexer& in) const noexcept {
+	char* dst = static_cast<char*>(obj);
+	return collection<indexer>::read(*this, dst, in);
+}
+
+bool schema::read(char* obj, lexer& in, const char_t* name) const noexcept {
+	for(size_t i = 0; i < size; ++i) {
+		const descriptor& d(table[i]);
+		if( match(caption<>::text(d.id), name) ) {
+			read(d, d.kind, obj + d.offset, in);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool schema::read(const descriptor& d, descriptor::kind_t k,
+		char* dst, lexer& in) noexcept {
+	typedef descriptor::kind_t kind_t;
+	switch( k ) {
+	case kind_t::boolean:	return reader<bool>::read(as<bool>(dst), in);
+	case kind_t::i8:		return reader<int8_t>::read(as<int8_t>(dst), in);
+	case kind_t::u8:		return reader<uint8_t>::read(as<uint8_t>(dst), in);
+	case kind_t::i16:		return reader<int16_t>::read(as<int16_t>(dst), in);
+	case kind_t::u16:		return reader<uint16_t>::read(as<uint16_t>(dst),in);
+	case kind_t::i32:		return reader<int32_t>::read(as<int32_t>(dst), in);
+	case kind_t::u32:		return reader<uint32_t>::read(as<uint32_t>(dst),in);
+	case kind_t::i64:		return reader<int64_t>::read(as<int64_t>(dst), in);
+	case kind_t::u64:		return reader<uint64_t>::read(as<uint64_t>(dst),in);
+	case kind_t::f32:		return reader<float>::read(as<float>(dst), in);
+	case kind_t::f64:		return reader<double>::read(as<double>(dst), in);
+	case kind_t::string:
+		return reader<char_t*>::read(&as<char_t>(dst),
+			k == d.kind ? d.count : d.stride / sizeof(char_t), in);
+	case kind_t::object:
+		return schema(d.nested, d.size).read(dst, in);
+	case kind_t::array:
+		return collection<>::read(items{d}, dst, in);
+	default:
+		in.error(error_t::noobject);
+		return in.skip();
+	}
+}
+
+/* descriptor seen as a member for member::prolog						*/
+struct titled {
+	const descriptor& d;
+	inline cstring name() const noexcept { return caption<>::text(d.id); }
+	inline fragment prefix() const noexcept {
+		return caption<>::text(d.prefix);
+	}
+};
+
+bool schema::write(const void* obj, ostream& out) const noexcept {
+	const char* src = static_cast<const char*>(obj);
+	bool r = true;
+	for(size_t i = 0; i < size && r; ++i) {
+		const descriptor& d(table[i]);
+		r = member::prolog(i==0, titled{d}, out) &&
+			write(d, d.kind, src + d.offset, out);
+	}
+	return r && object::end(out);
+}
+
+bool schema::write(const descriptor& d, descriptor::kind_t k,
+		const char* src, ostream& out) noexcept {
+	typedef descriptor::kind_t kind_t;
+	switch( k ) {
+	case kind_t::boolean:	return writer<bool>::write(as<bool>(src), out);
+	case kind_t::i8:		return writer<int8_t>::write(as<int8_t>(src), out);
+	case kind_t::u8:		return writer<uint8_t>::write(as<uint8_t>(src),out);
+	case kind_t::i16:		return writer<int16_t>::write(as<int16_t>(src),out);
+	case kind_t::u16:		return writer<uint16_t>::write(as<uint16_t>(src),out);
+	case kind_t::i32:		return writer<int32_t>::write(as<int32_t>(src),out);
+	case kind_t::u32:		return writer<uint32_t>::write(as<uint32_t>(src),out);
+	case kind_t::i64:		return writer<int64_t>::write(as<int64_t>(src),out);
+	case kind_t::u64:		return writer<uint64_t>::write(as<uint64_t>(src),out);
+	case kind_t::f32:		return writer<float>::write(as<float>(src), out);
+	case kind_t::f64:		return writer<double>::write(as<double>(src), out);
+	case kind_t::string:
+		return writer<const char_t*>::write(&as<char_t>(src), out);
+	case kind_t::object:
+		return schema(d.nested, d.size).write(src, out);
+	case kind_t::array:
+		return array::write(items{d}, src, out);
+	default:
+		return value::null(out);
+	}
+}
+
 bool object::write(ostream& out) const noexcept {
 	bool r = true;
 	for(size_t i = 0; i<size && r ; ++i) {
 		const member& m(nodes[i]());
 		//TODO skip members with no value
-		r = dlm(i==0, out) &&
-			m.prolog(out)  &&
+		r = member::prolog(i==0, m, out) &&
 			m.writeval(out);
 	}
 	return r && end(out);
@@ -537,4 +914,643 @@ bool object::read(lexer& in, const char_t * name) const noexcept {
 	return false;
 }
 
+namespace pointer {
+/* JSON Pointer segments, RFC 6901 */
+static constexpr char_t separator = '/';
+static constexpr char_t tilde = '~';
+static constexpr char_t wildcard = '*';
+
+static inline bool ends(cstring p) noexcept {
+	return *p == 0 || *p == separator;
+}
+
+/** number of segments in path p, paths not starting with / have none	*/
+static size_t length(cstring p) noexcept {
+	size_t n = 0;
+	for(; *p; ++p) if( *p == separator ) ++n;
+	return n;
+}
+
+/** beginning of segment d of path p									*/
+static cstring segment(cstring p, size_t d) noexcept {
+	for(++p; d; ++p) if( *p == separator ) --d;
+	return p;
+}
+
+static inline bool any(cstring seg) noexcept {
+	return *seg == wildcard && (++seg, ends(seg));
+}
+
+/** tells if every ~ in path p is followed by 0 or 1					*/
+static bool valid(cstring p) noexcept {
+	for(; *p; ++p)
+		if( *p == tilde && (++p, *p != literal::digit0 &&
+				*p != literal::digit0 + 1) )
+			return false;
+	return true;
+}
+
+/** matches segment with a member name, unescaping ~0 and ~1			*/
+static bool same(cstring seg, const char_t* name) noexcept {
+	for(; ! ends(seg); ++seg, ++name) {
+		char_t c = *seg;
+		if( c == tilde ) {
+			++seg;
+			c = *seg == literal::digit0 + 1 ? separator : tilde;
+		}
+		if( c != *name ) return false;
+	}
+	return *name == 0;
+}
+
+/** tells if pointers a and b may select the same value, or one within
+ * the other, i.e. their common segments are equal or wildcards			*/
+static bool overlap(cstring a, cstring b) noexcept {
+	const size_t la = length(a), lb = length(b);
+	for(size_t d = 0; d < la && d < lb; ++d) {
+		cstring x = segment(a, d), y = segment(b, d);
+		if( any(x) || any(y) ) continue;
+		for(; ! ends(x) && *x == *y; ++x, ++y);
+		if( ! ends(x) || ! ends(y) ) return false;
+	}
+	return true;
+}
+
+/** matches segment with an array index, leading zeros are not allowed	*/
+static bool same(cstring seg, size_t index) noexcept {
+	size_t n = 0;
+	if( ends(seg) ) return false;
+	if( *seg == literal::digit0 && ! ends(seg + 1) ) return false;
+	for(; ! ends(seg); ++seg) {
+		if( *seg < literal::digit0 || *seg > literal::digit0 + 9 )
+			return false;
+		n = n * 10 + (*seg - literal::digit0);
+	}
+	return n == index;
+}
+} /* namespace pointer */
+
+selector::mask selector::plains(const path* list, size_t n) noexcept {
+	mask r = 0;
+	for(size_t i = 0; i < n; ++i) {
+		bool plain = *list[i].pointer == 0 ||
+			*list[i].pointer == pointer::separator;
+		for(size_t d = pointer::length(list[i].pointer); plain && d--; )
+			plain = ! pointer::any(pointer::segment(list[i].pointer, d));
+		if( plain ) r |= bit(i);
+	}
+	return r;
+}
+
+bool selector::malformed(const path* list, size_t n) noexcept {
+	for(size_t i = 0; i < n; ++i)
+		if( ! pointer::valid(list[i].pointer) ) return true;
+	return false;
+}
+
+bool selector::overlapping(const path* list, size_t n) noexcept {
+	for(size_t i = 0; i < n; ++i) {
+		if( *list[i].pointer != 0 && *list[i].pointer != pointer::separator )
+			continue;
+		for(size_t j = i + 1; j < n; ++j)
+			if( ( *list[j].pointer == 0 ||
+				  *list[j].pointer == pointer::separator ) &&
+				pointer::overlap(list[i].pointer, list[j].pointer) )
+				return true;
+	}
+	return false;
+}
+
+bool selector::read(istream& in) const noexcept {
+	lexer lex(in, policy::skipping());
+	return read(lex);
+}
+
+bool selector::read(lexer& in) const noexcept {
+	if( ! sound ) {
+		in.error(error_t::bad);
+		return false;
+	}
+	mask done = 0;
+	mask alive = 0;
+	for(size_t i = 0; i < count; ++i)
+		if( *paths[i].pointer == 0 || *paths[i].pointer == pointer::separator )
+			alive |= bit(i);
+	return walk(in, alive, 0, done);
+}
+
+bool selector::walk(lexer& in, mask alive, size_t depth,
+		mask& done) const noexcept {
+	for(size_t i = 0; i < count; ++i)
+		if( (alive & bit(i)) && pointer::length(paths[i].pointer) == depth ) {
+			done |= bit(i) & plain;
+			return paths[i].target().read(in);
+		}
+	char_t chr;
+	if( ! in.skipws(chr) ) return false;
+	in.back(chr);
+	switch( chr ) {
+	case literal::begin_object: return members(in, alive, depth, done);
+	case literal::begin_array:  return items(in, alive, depth, done);
+	default:					return in.skip(false);
+	}
+}
+
+bool selector::members(lexer& in, mask alive, size_t depth,
+		mask& done) const noexcept {
+	char_t chr;
+	if( ! in.skipws(chr) || chr != literal::begin_object ) return false;
+	if( ! in.skipws(chr) ) return false;
+	if( chr == literal::end_object ) return true;
+	in.back(chr);
+	do {
+		char_t* name;
+		if( ! in.member(name) ) return false;
+		mask next = 0;
+		for(size_t i = 0; i < count; ++i) {
+			if( ! (alive & bit(i)) || (done & bit(i)) ||
+				pointer::length(paths[i].pointer) <= depth ) continue;
+			cstring seg = pointer::segment(paths[i].pointer, depth);
+			if( pointer::any(seg) || pointer::same(seg, name) )
+				next |= bit(i);
+		}
+		if( ! (next ? walk(in, next, depth + 1, done) : in.skip(false)) )
+			return false;
+		if( complete(done) ) return true;
+		if( ! in.skipws(chr) ) return false;
+	} while( chr == literal::value_separator );
+	if( chr == literal::end_object ) return true;
+	in.bad();
+	return false;
+}
+
+bool selector::items(lexer& in, mask alive, size_t depth,
+		mask& done) const noexcept {
+	char_t chr;
+	if( ! in.skipws(chr) || chr != literal::begin_array ) return false;
+	if( ! in.skipws(chr) ) return false;
+	if( chr == literal::end_array ) return true;
+	in.back(chr);
+	size_t index = 0;
+	do {
+		mask next = 0;
+		for(size_t i = 0; i < count; ++i) {
+			if( ! (alive & bit(i)) || (done & bit(i)) ||
+				pointer::length(paths[i].pointer) <= depth ) continue;
+			cstring seg = pointer::segment(paths[i].pointer, depth);
+			if( pointer::any(seg) || pointer::same(seg, index) )
+				next |= bit(i);
+		}
+		if( ! (next ? walk(in, next, depth + 1, done) : in.skip(false)) )
+			return false;
+		if( complete(done) ) return true;
+		if( ! in.skipws(chr) ) return false;
+		++index;
+	} while( chr == literal::value_separator );
+	if( chr == literal::end_array ) return true;
+	in.bad();
+	return false;
+}
+
+tokens::kind tokens::next() noexcept {
+	char_t chr;
+	if( open ) {
+		/* skip unread part of the current key or string				*/
+		char_t tmp[8];
+		while( read(tmp, sizeof(tmp) / sizeof(tmp[0])) );
+	}
+	txt = view();
+	for(;;) {
+		switch( expect ) {
+		case state::done:	return kind::end;
+		case state::failed:	return kind::error;
+		default:;
+		}
+		if( ! in.skipws(chr) ) {
+			if( expect != state::start || chr != iostate::eos_c )
+				return fail();
+			expect = state::done;
+			return kind::end;
+		}
+		switch( expect ) {
+		case state::item:
+			if( chr == literal::end_array ) return close(kind::end_array);
+			/* falls through */
+		case state::start:
+		case state::value:
+			return value(chr);
+		case state::member:
+			if( chr == literal::end_object ) return close(kind::end_object);
+			/* falls through */
+		case state::key:
+			if( chr != literal::quotation_mark ) return fail();
+			return string(kind::key, state::colon);
+		case state::colon:
+			if( chr != literal::name_separator ) return fail();
+			expect = state::value;
+			continue;
+		case state::after:
+			if( chr == literal::value_separator ) {
+				expect = object() ? state::key : state::value;
+				continue;
+			}
+			if( object() && chr == literal::end_object )
+				return close(kind::end_object);
+			if( ! object() && chr == literal::end_array )
+				return close(kind::end_array);
+			/* falls through */
+		default:
+			return fail();
+		}
+	}
+}
+
+tokens::kind tokens::value(char_t chr) noexcept {
+	switch( chr ) {
+	case literal::begin_object:
+	case literal::begin_array:
+		if( level == sizeof(nest) * 8 ) {
+			in.error(error_t::overrun);
+			return fail();
+		}
+		++level;
+		nest <<= 1;
+		if( chr == literal::begin_array ) {
+			expect = state::item;
+			return kind::begin_array;
+		}
+		nest |= 1;
+		expect = state::member;
+		return kind::begin_object;
+	case literal::quotation_mark:
+		return string(kind::string, following());
+	default:;
+	}
+	if( chr == literal::minus || (chr >= literal::digit0 &&
+			chr <= literal::digit0 + 9) ) {
+		size_t n = 0;
+		ctype ct;
+		num[n++] = chr;
+		while( (ct=in.get(chr, ctype::number)) > ctype::unknown ) {
+			if( n == sizeof(num) / sizeof(num[0]) ) {
+				in.error(error_t::overrun);
+				return fail();
+			}
+			num[n++] = chr;
+		}
+		if( ct == ctype::unknown ) in.back(chr);
+		else if( ct != ctype::eof ) return fail();
+		txt = view(num, n);
+		expect = following();
+		return kind::number;
+	}
+	in.back(chr);
+	ctype ct = in.value(ctype::boolean | ctype::null);
+	if( ct == ctype::null ) {
+		expect = following();
+		return kind::null;
+	}
+	if( (ct & ctype::boolean) == ctype::boolean ) {
+		flag = (ct & ctype::value) == ctype::value;
+		expect = following();
+		return kind::boolean;
+	}
+	return fail();
+}
+
+tokens::kind tokens::string(kind k, state then) noexcept {
+	expect = then;
+	open = ! in.plain(txt);
+	return k;
+}
+
+tokens::kind tokens::close(kind k) noexcept {
+	nest >>= 1;
+	--level;
+	expect = following();
+	return k;
+}
+
+size_t tokens::read(char_t* dst, size_t n) noexcept {
+	size_t r = 0;
+	char_t chr;
+	while( open && r < n ) {
+		ctype ct = in.string(chr, false);
+		if( ct == ctype::string )
+			dst[r++] = chr;
+		else {
+			open = false;
+			if( ct != ctype::delim ) fail();
+		}
+	}
+	return r;
+}
+
+bool tokens::skip() noexcept {
+	const size_t l = level;
+	while( level >= l && l != 0 ) {
+		kind k = next();
+		if( k == kind::error || k == kind::end ) return false;
+	}
+	return true;
+}
+
+bool tape::add(kind type, size_t at, size_t size) noexcept {
+	if( count == capacity ) return fail(error_t::overrun);
+	cell& c = data[count++];
+	c.type = type;
+	c.at = at;
+	c.size = size;
+	c.end = 0;
+	return true;
+}
+
+bool tape::string(kind type, size_t& pos, size_t n) noexcept {
+	const size_t start = ++pos;
+	for(; pos < n; ++pos) {
+		const char_t chr = input[pos];
+		if( chr == literal::quotation_mark ) {
+			++pos;
+			return add(type, start, pos - start - 1);
+		}
+		if( literal::is_control(chr) ) return fail(error_t::bad);
+		if( chr == literal::escape && ++pos == n ) break;
+	}
+	return fail(error_t::eof);
+}
+
+/* true if nothing but the end is left in the lexer						*/
+static inline bool drained(lexer& lex) noexcept {
+	char_t chr;
+	return ! lex.skipws(chr) || chr == iostate::eos_c;
+}
+
+bool tape::number(size_t& pos, size_t n) noexcept {
+	const size_t start = pos;
+	bool integral = true;
+	for(; pos < n; ++pos) {
+		const char_t chr = input[pos];
+		if( chr >= literal::digit0 && chr <= literal::digit0 + 9 ) continue;
+		if( chr == literal::minus ) continue;
+		if( chr != literal::decimal && chr != literal::plus &&
+			chr != 'e' && chr != 'E' ) break;
+		integral = false;
+	}
+	if( integral ) {
+		long val = 0;
+		source src(input + start, pos - start);
+		lexer lex(src);
+		if( reader<long>::read(val, lex) &&
+			(lex.error() & ~error_t::eof) == error_t::noerror &&
+			drained(lex) && add(kind::integer, start, pos - start) ) {
+			data[count-1].integer = val;
+			return true;
+		}
+		if( err != error_t::noerror ) return false;
+	}
+	double val = 0;
+	source src(input + start, pos - start);
+	lexer lex(src);
+	if( ! reader<double>::read(val, lex) || ! drained(lex) )
+		return fail(error_t::bad);
+	if( ! add(kind::real, start, pos - start) ) return false;
+	data[count-1].real = val;
+	return true;
+}
+
+bool tape::scalar(size_t& pos, size_t n) noexcept {
+	static const char* const words[] = { "false", "true", "null" };
+	for(unsigned w = 0; w < countof(words); ++w) {
+		size_t i = 0;
+		while( words[w][i] && pos + i < n && input[pos + i] == words[w][i] )
+			++i;
+		if( words[w][i] ) continue;
+		if( ! add(w < 2 ? kind::boolean : kind::null, pos, i) ) return false;
+		data[count-1].boolean = w == 1;
+		pos += i;
+		return true;
+	}
+	return fail(error_t::bad);
+}
+
+bool tape::parse(const char_t* json) noexcept {
+	size_t n = 0;
+	while( json[n] ) ++n;
+	return parse(json, n);
+}
+
+/* open containers are chained through their end fields until closed	*/
+bool tape::parse(const char_t* json, size_t n) noexcept {
+	enum class state : unsigned char { value, item, member, key, colon, after };
+	state expect = state::value;
+	size_t open = none;
+	size_t pos = 0;
+	input = json;
+	count = 0;
+	err = error_t::noerror;
+	for(;;) {
+		while( pos < n && isws(json[pos]) ) ++pos;
+		if( expect == state::after && open == none )
+			return pos == n || fail(error_t::bad);
+		if( pos == n ) return fail(error_t::eof);
+		const char_t chr = json[pos];
+		switch( expect ) {
+		case state::colon:
+			if( chr != literal::name_separator ) return fail(error_t::bad);
+			++pos;
+			expect = state::value;
+			continue;
+		case state::after:
+			if( chr == literal::value_separator ) {
+				++pos;
+				expect = data[open].type == kind::object ?
+					state::key : state::value;
+				continue;
+			}
+			if( chr != (data[open].type == kind::object ?
+					literal::end_object : literal::end_array) )
+				return fail(error_t::bad);
+			break;
+		case state::member:
+			if( chr == literal::end_object ) break;
+			/* falls through */
+		case state::key:
+			if( chr != literal::quotation_mark ) return fail(error_t::bad);
+			++data[open].size;
+			if( ! string(kind::key, pos, n) ) return false;
+			expect = state::colon;
+			continue;
+		case state::item:
+			if( chr == literal::end_array ) break;
+			/* falls through */
+		case state::value:
+			if( expect != state::value ) ++data[open].size;
+			else if( open != none && data[open].type == kind::array )
+				++data[open].size;
+			expect = state::after;
+			if( chr == literal::begin_object || chr == literal::begin_array ) {
+				const bool object = chr == literal::begin_object;
+				if( ! add(object ? kind::object : kind::array, pos++, 0) )
+					return false;
+				data[count-1].end = open;
+				open = count - 1;
+				expect = object ? state::member : state::item;
+				continue;
+			}
+			if( chr == literal::quotation_mark ) {
+				if( ! string(kind::string, pos, n) ) return false;
+				continue;
+			}
+			if( chr == literal::minus ||
+				(chr >= literal::digit0 && chr <= literal::digit0 + 9) ) {
+				if( ! number(pos, n) ) return false;
+				continue;
+			}
+			if( ! scalar(pos, n) ) return false;
+			continue;
+		}
+		/* closing bracket of the innermost open container				*/
+		++pos;
+		const size_t outer = data[open].end;
+		data[open].end = count;
+		open = outer;
+		expect = state::after;
+	}
+}
+
+size_t tape::item(size_t i, size_t n) const noexcept {
+	if( i >= count || (data[i].type != kind::object &&
+			data[i].type != kind::array) || n >= data[i].size )
+		return none;
+	const bool object = data[i].type == kind::object;
+	size_t j = i + 1;
+	for(;;) {
+		if( object ) ++j;
+		if( n-- == 0 ) return j;
+		j = next(j);
+	}
+}
+
+size_t tape::find(size_t i, const char_t* name) const noexcept {
+	if( i >= count || data[i].type != kind::object ) return none;
+	for(size_t j = i + 1; j < data[i].end; j = next(j + 1))
+		if( matches(j, name) ) return j + 1;
+	return none;
+}
+
+/* compares decoded key i with name, escapes in the key are resolved	*/
+bool tape::matches(size_t i, const char_t* name) const noexcept {
+	/* text is followed by the closing quotation mark					*/
+	source src(input + data[i].at, data[i].size + 1);
+	lexer lex(src);
+	char_t chr;
+	ctype ct;
+	while( (ct=lex.string(chr, false)) == ctype::string )
+		if( *name == 0 || *name++ != chr ) return false;
+	return ct == ctype::delim && *name == 0;
+}
+
+bool tape::read(size_t i, char_t* dst, size_t n) const noexcept {
+	if( i >= count || n == 0 || (data[i].type != kind::key &&
+			data[i].type != kind::string) )
+		return false;
+	/* text is followed by the closing quotation mark					*/
+	source src(input + data[i].at, data[i].size + 1);
+	lexer lex(src);
+	char_t chr;
+	ctype ct;
+	size_t k = 0;
+	while( (ct=lex.string(chr, false)) == ctype::string ) {
+		if( k + 1 == n ) {
+			dst[k] = 0;
+			return false;
+		}
+		dst[k++] = chr;
+	}
+	dst[k] = 0;
+	return ct == ctype::delim;
+}
+
+bool tape::write(ostream& out, size_t i) const noexcept {
+	if( i >= count ) return false;
+	const cell& c = data[i];
+	switch( c.type ) {
+	case kind::object:
+	case kind::array: {
+		const bool object = c.type == kind::object;
+		bool r = out.put(object ? literal::begin_object : literal::begin_array);
+		for(size_t j = i + 1; r && j < c.end; j = next(j)) {
+			if( j != i + 1 ) r = out.put(literal::value_separator);
+			if( object ) {
+				r = r && write(out, j) && out.put(literal::name_separator);
+				++j;
+			}
+			r = r && write(out, j);
+		}
+		return r && out.put(object ? literal::end_object : literal::end_array);
+	}
+	case kind::key:
+	case kind::string:
+		return out.put(literal::quotation_mark) &&
+			out.write(input + c.at, c.size) &&
+			out.put(literal::quotation_mark);
+	case kind::integer:
+	case kind::real:
+		return out.write(input + c.at, c.size);
+	case kind::boolean:
+		return writer<bool>::write(c.boolean, out);
+	case kind::null:
+		return value::null(out);
+	}
+	return false;
+}
+
+bool lines::end(char_t& dst) noexcept {
+	window(nullptr, nullptr);
+	dst = iostate::eos_c;
+	error(error_t::eof);
+	return false;
+}
+
+bool lines::get(char_t& dst) noexcept {
+	if( ended || over ) return end(dst);
+	if( in.gnext != in.gend ) {
+		/* pass the part of the line in the window through				*/
+		const char_t* const begin = in.gnext;
+		const char_t* p = begin;
+		while( p != in.gend && *p != newline ) ++p;
+		if( p != begin ) {
+			chars += static_cast<unsigned long>(p - begin);
+			in.gnext = p;
+			window(begin + 1, p);
+			dst = *begin;
+			return true;
+		}
+		++in.gnext;
+		++chars;
+		ended = true;
+		return end(dst);
+	}
+	if( ! in.get(dst) ) {
+		over = true;
+		if( dst == iostate::eos_c ) return end(dst);
+		error(error_t::ioerror);
+		return false;
+	}
+	++chars;
+	if( dst != newline ) return true;
+	ended = true;
+	return end(dst);
+}
+
+bool lines::advance() noexcept {
+	char_t chr;
+	if( started )
+		while( get(chr) );
+	started = true;
+	ended = false;
+	clear();
+	return ! over;
+}
+
 }}
@@ -63,6 +63,13 @@ namespace cojson {
 			error
 		} mismatch = mismatch_is::skipped;
 
+		/** controls where the parsing rules, overflow and mismatch, are kept */
+		static constexpr enum class policy_is {
+			per_build,	/** constant, checks not needed are compiled out	*/
+			per_lexer	/** held by each lexer, lexers with different rules
+							may coexist, see details::policy				*/
+		} policy = policy_is::per_build;
+
 		/** controls default null handling.
 		 *  could be overridden in a custom accessor						*/
 		static constexpr enum class null_is {
@@ -70,11 +77,12 @@ namespace cojson {
 			error, 		/** overflow causes an error						*/
 		} null = null_is::skipped;
 
-		/** controls implementation of temporary buffer, used for reading
-		 * 	names and writing floating data types							*/
+		/** controls implementation of lexer's temporary buffer, used for
+		 *  reading names, unless the lexer is given a scratch buffer		*/
 		static constexpr enum class temporary_is {
-			_static,	/**	temporary buffer preallocated in static data	*/
-			_automatic	/**	temporary buffer allocated on the stack 		*/
+			_static,	/**	temporary buffer preallocated in static data,
+							shared by all lexers, not re-entrant			*/
+			_automatic	/**	temporary buffer allocated in each lexer 		*/
 		} temporary = (sizeof(double) < 8) ?
 		 /* by default temporary buffer is static on low end CPU (AVR 8 bit).
 		  * sizeof(double) is used as indication of lowendness				*/
@@ -90,6 +98,26 @@ namespace cojson {
 		} write_double_impl = write_double_impl_is::internal;
 		using write_double_integral_type = uint32_t;
 		static constexpr unsigned write_double_precision = 6;
+
+		/** controls writing of constant member names					*/
+		static constexpr enum class names_is {
+			escaped,	/** names are escaped and quoted on each write		*/
+			prebuilt	/** names are written as ,"name": fragments built at
+							compile time, copied in data memory 			*/
+		} names = (sizeof(double) < 8) ?
+		 /* by default fragments are not built on low end CPU (AVR 8 bit),
+		  * where constant data is not in the program memory				*/
+			names_is::escaped : names_is::prebuilt;
+
+		/** controls writing of arrays of integers						*/
+		static constexpr enum class integers_is {
+			itemized,	/** item by item, with writer<T>					*/
+			batched		/** two digits at a time, with a table of digit
+							pairs, into a buffer on stack written in spans	*/
+		} integers = (sizeof(double) < 8) ?
+		 /* by default not batched on low end CPU (AVR 8 bit), where the
+		  * table would take data memory									*/
+			integers_is::itemized : integers_is::batched;
 	private:
 		default_config();
 	};
@@ -294,6 +322,7 @@ struct array {
 	static constexpr bool canlref   = true;
 	static constexpr bool canrref   = true;
 	static constexpr bool is_vector = true;
+	static constexpr size_t extent = N;	/* items are contiguous			*/
 	static inline bool has(size_t i) noexcept { return i < N; }
 	static inline const T get(size_t i) noexcept { return A[i]; }
 	static inline T& lref(size_t i) noexcept { return A[i]; }
@@ -480,11 +509,13 @@ private:
 	noncopyable(const noncopyable&);
 	noncopyable& operator=(const noncopyable&);
 public:
-	noncopyable() { }
+	constexpr noncopyable() { }
 };
 
 struct value;
 struct member;
+template<class C> struct property;
+template<class C> struct clas;
 
 /**
  * unnamed element
@@ -501,6 +532,83 @@ typedef const member& (*node)();
  */
 typedef cstring (*name)();
 
+/**
+ * fragment - a constant piece of JSON text, not zero-terminated
+ */
+struct fragment {
+	const char_t* str;
+	size_t len;
+	inline constexpr bool empty() const noexcept { return str == nullptr; }
+};
+
+template<typename T>
+static inline constexpr size_t cslen(T s, size_t n = 0) noexcept {
+	return s[n] ? cslen(s, n+1) : n;
+}
+
+/** true if string s can be written verbatim, without escaping				*/
+template<typename T>
+static inline constexpr bool verbatim(T s) noexcept {
+	return *s == 0 || ( ! literal::is_control(*s) &&
+						! literal::is_escaped(*s) && verbatim(s+1) );
+}
+
+/**
+ * quoted member name with separators, e.g. ,"name":
+ * built at compile time, first character is replaced with { if needed
+ */
+template<name id, class = typename make_indices<cslen(id())>::type>
+struct quoted;
+
+template<name id, unsigned ... I>
+struct quoted<id, indices<I...>> {
+	static constexpr char_t text[] = {
+		literal::value_separator,
+		literal::quotation_mark,
+		id()[I]...,
+		literal::quotation_mark,
+		literal::name_separator
+	};
+	static inline constexpr fragment get() noexcept {
+		return fragment{text, sizeof(text)/sizeof(text[0])};
+	}
+};
+
+template<name id, unsigned ... I>
+constexpr char_t quoted<id, indices<I...>>::text[];
+
+/**
+ * prefix selector - prebuilt quoted name is available only for names
+ * that are constant expressions and need no escaping, and only if
+ * configured so (see config::names).
+ * progmem names always go via writer<cstring>
+ */
+template<name id, bool = config::names == config::names_is::prebuilt &&
+	detectors::is_constexpr<name,id>::value>
+struct prefix {
+	static inline constexpr fragment get() noexcept {
+		return fragment{nullptr, 0};
+	}
+};
+
+template<name id>
+struct prefix<id, true>
+  : std::conditional<verbatim(id()), quoted<id>, prefix<id,false>>::type {};
+
+/**
+ * source of member name prefixes, virtual only if names are prebuilt,
+ * so that vtables of members and properties do not grow otherwise
+ */
+template<config::names_is = config::names>
+struct prefixed {
+	inline fragment prefix() const noexcept { return fragment{nullptr, 0}; }
+};
+
+template<>
+struct prefixed<config::names_is::prebuilt> {
+	virtual fragment prefix() const noexcept { return fragment{nullptr, 0}; }
+};
+
 /**
  * Error codes
  */
@@ -555,6 +663,7 @@ class iostate_t;
 template<>
 struct iostate_t<config::iostate_is::_virtual> : noncopyable {
 	static constexpr bool isvirtual = true;
+	iostate_t() noexcept : err(error_t::noerror) {}
 	virtual void error(error_t e) noexcept { err |= e; }
 	virtual error_t error() const noexcept { return err; }
 	virtual void clear() noexcept { err = error_t::noerror; }
@@ -569,6 +678,7 @@ private:
 template<>
 struct iostate_t<config::iostate_is::_notvirtual> : noncopyable {
 	static constexpr bool isvirtual = false;
+	iostate_t() noexcept : err(error_t::noerror) {}
 	inline void error(error_t e) noexcept { err |= e; }
 	inline error_t error() const noexcept { return err; }
 	inline void clear() noexcept { err = error_t::noerror; }
@@ -605,6 +715,41 @@ struct istream : virtual iostate {
 	 * in latter case dst holds error code (fail or eof)
 	 */
 	virtual bool get(char_t& dst) noexcept = 0;
+	/**
+	 * reads a single character from the inline window, if the stream
+	 * provides one, otherwise from get. Used by the lexer
+	 */
+	inline bool next(char_t& dst) noexcept {
+		if( gnext != gend ) {
+			dst = *gnext++;
+			return true;
+		}
+		return get(dst);
+	}
+protected:
+	inline istream() noexcept
+	  : gnext(nullptr), gend(nullptr), gwritable(false) {}
+	/**
+	 * sets inline window - characters [b, e) that the lexer may read
+	 * without calling get. get is called when the window is exhausted
+	 * and may set a new window. Reading position of such stream is gnext
+	 */
+	inline void window(const char_t* b, const char_t* e) noexcept {
+		gnext = b;
+		gend = e;
+	}
+	/**
+	 * marks the window as writable, so that the lexer may decode
+	 * escaped strings in place
+	 */
+	inline void writable(bool w) noexcept {
+		gwritable = w;
+	}
+	friend struct lexer;
+	friend class lines;
+	const char_t* gnext;
+	const char_t* gend;
+	bool gwritable;
 };
 
 /**
@@ -622,9 +767,50 @@ struct ostream : virtual iostate {
 	 * returns true on success or false on error
 	 */
 	inline bool put(const char_t* s) noexcept { return puts(s); }
+	/**
+	 * writes n characters from s to the stream.
+	 * returns true on success or false on error
+	 */
+	virtual bool write(const char_t* s, size_t n) noexcept;
 	bool puts(const char_t* s) noexcept;
 	template<class C>
 	bool puts(C s) noexcept;
+	/**
+	 * writes a single character into the put area, if the stream
+	 * provides one, otherwise with put. Used by writers
+	 */
+	inline bool emit(char_t c) noexcept {
+		if( pnext != pend ) {
+			*pnext++ = c;
+			return true;
+		}
+		return put(c);
+	}
+	/**
+	 * writes n characters from s into the put area if they fit there,
+	 * otherwise with write
+	 */
+	inline bool emit(const char_t* s, size_t n) noexcept {
+		if( n <= static_cast<size_t>(pend - pnext) ) {
+			while( n-- ) *pnext++ = *s++;
+			return true;
+		}
+		return write(s, n);
+	}
+protected:
+	inline ostream() noexcept : pnext(nullptr), pend(nullptr) {}
+	/**
+	 * sets put area - characters [b, e) that writers may fill without
+	 * calling put. put is called when the area is full and may set a new
+	 * area, but it is also called directly, so it must write into the area
+	 * while there is room. Writing position of such stream is pnext
+	 */
+	inline void area(char_t* b, char_t* e) noexcept {
+		pnext = b;
+		pend = e;
+	}
+	char_t* pnext;
+	char_t* pend;
 };
 
 template<>
@@ -724,11 +910,199 @@ static inline /*constexpr*/ bool isws(char_t chr) noexcept {
 	return hasbits(chartype(chr), ctype::whitespace);
 }
 
+/** integral types other than bool, read and written as plain numbers		*/
+template<typename T>
+struct numeral : std::integral_constant<bool,
+	std::is_integral<T>::value && ! std::is_same<T, bool>::value> {};
+
+/** types read from arrays in the inline window, see lexer::numbers		*/
+template<typename T>
+struct scanned : std::integral_constant<bool,
+	numeral<T>::value || std::is_same<T, double>::value> {};
+
+/** numerals written in batches, see digits::write and config::integers	*/
+template<typename T>
+struct batched : std::integral_constant<bool, numeral<T>::value &&
+	config::integers == config::integers_is::batched> {};
+
+/**
+ * view - a string in the input buffer given by pointer and length, not
+ * zero-terminated. Valid as long as the buffer lives and is not reused
+ */
+struct view {
+	inline constexpr view() noexcept : ptr(nullptr), len(0) {}
+	inline constexpr view(const char_t* p, size_t n) noexcept
+	  : ptr(p), len(n) {}
+	inline constexpr const char_t* data() const noexcept { return ptr; }
+	inline constexpr size_t size() const noexcept { return len; }
+	inline constexpr const char_t* begin() const noexcept { return ptr; }
+	inline constexpr const char_t* end() const noexcept { return ptr + len; }
+	inline constexpr bool null() const noexcept { return ptr == nullptr; }
+	/** compares with a zero-terminated string							*/
+	bool operator==(const char_t* s) const noexcept {
+		if( ptr == nullptr || s == nullptr ) return ptr == s;
+		size_t i = 0;
+		while( i < len && s[i] && s[i] == ptr[i] ) ++i;
+		return i == len && s[i] == 0;
+	}
+	inline bool operator!=(const char_t* s) const noexcept {
+		return ! (*this == s);
+	}
+private:
+	const char_t* ptr;
+	size_t len;
+};
+
 /**
- * Lexer/scanner
+ * arena - bump allocator over a caller supplied buffer. Memory is taken
+ * from the top and released all at once with reset, e.g. per document.
+ * A string may be built at the top of the arena one character at a time
+ * with put and then completed with take or discarded with drop.
+ * Used by the lexer to place strings that can not be read as views into
+ * the input buffer
  */
-struct lexer : noncopyable {
-	inline lexer(istream& in) noexcept : stream(in), hold(0) {}
+class arena : noncopyable {
+public:
+	inline arena(void* data, size_t size) noexcept
+	  : base(static_cast<char*>(data)), limit(size), top(0), open(0) {}
+	template<size_t N>
+	inline arena(char (&data)[N]) noexcept : arena(data, N) {}
+	/** allocates n bytes aligned at a, returns nullptr if exhausted		*/
+	void* allocate(size_t n, size_t a) noexcept {
+		drop();
+		size_t at = offset(top, a);
+		if( at > limit || n > limit - at ) return nullptr;
+		top = at + n;
+		return base + at;
+	}
+	template<typename T>
+	inline T* allocate(size_t n = 1) noexcept {
+		return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+	}
+	/** appends a character to the string being built					*/
+	bool put(char_t c) noexcept {
+		size_t at = offset(top, alignof(char_t)) + open;
+		if( at > limit || limit - at < 2 * sizeof(char_t) ) return false;
+		*reinterpret_cast<char_t*>(base + at) = c;
+		open += sizeof(char_t);
+		return true;
+	}
+	/** completes the string being built, zero-terminated				*/
+	view take() noexcept {
+		size_t n = open / sizeof(char_t);
+		char_t* str = static_cast<char_t*>(allocate(open + sizeof(char_t),
+			alignof(char_t)));
+		if( str == nullptr ) return view();
+		str[n] = 0;
+		return view(str, n);
+	}
+	/** discards the string being built									*/
+	inline void drop() noexcept { open = 0; }
+	/** string being built, not terminated yet							*/
+	inline view pending() const noexcept {
+		return view(reinterpret_cast<const char_t*>(
+			base + offset(top, alignof(char_t))), open / sizeof(char_t));
+	}
+	/** releases all memory taken										*/
+	inline void reset() noexcept { top = open = 0; }
+	inline size_t used() const noexcept { return top; }
+	inline size_t capacity() const noexcept { return limit; }
+	/** tells if p points into the arena									*/
+	inline bool owns(const void* p) const noexcept {
+		return p >= base && p < base + limit;
+	}
+private:
+	inline size_t offset(size_t at, size_t a) const noexcept {
+		const std::size_t addr = reinterpret_cast<std::size_t>(base) + at;
+		return at + static_cast<size_t>((a - addr % a) % a);
+	}
+	char* const base;
+	const size_t limit;
+	size_t top;
+	size_t open;
+};
+
+/**
+ * policy - parsing rules of a lexer, overflow and mismatch handling.
+ * By default (config::policy_is::per_build) these are the constant rules
+ * of the build configuration, so that checks not needed are compiled out
+ * and a policy takes no space. With config::policy_is::per_lexer each lexer
+ * holds its own rules and lexers with different rules may coexist, e.g. a
+ * strict one for external input and a lenient one for internal data:
+ * struct strict : config {
+ *		static constexpr auto overflow = overflow_is::error;
+ *		static constexpr auto mismatch = mismatch_is::error;
+ * };
+ * lexer in(stream, policy::of<strict>());
+ * char_t, null and temporary are build-wide in either case
+ */
+template<config::policy_is = config::policy>
+struct policy_s {
+	static constexpr config::overflow_is overflow = config::overflow;
+	static constexpr config::mismatch_is mismatch = config::mismatch;
+	template<class Config = config>
+	static inline constexpr policy_s of() noexcept {
+		static_assert(Config::overflow == overflow &&
+			Config::mismatch == mismatch,
+			"Rules other than those of the build need per_lexer policy");
+		return policy_s{};
+	}
+	/** rules for skipping values not asked for, those of the build		*/
+	static inline constexpr policy_s skipping() noexcept {
+		return policy_s{};
+	}
+};
+
+template<config::policy_is P>
+constexpr config::overflow_is policy_s<P>::overflow;
+
+template<config::policy_is P>
+constexpr config::mismatch_is policy_s<P>::mismatch;
+
+template<>
+struct policy_s<config::policy_is::per_lexer> {
+	config::overflow_is overflow;
+	config::mismatch_is mismatch;
+	template<class Config = config>
+	static inline constexpr policy_s of() noexcept {
+		return policy_s{Config::overflow, Config::mismatch};
+	}
+	/** rules for skipping values not asked for, mismatches skipped		*/
+	static inline constexpr policy_s skipping() noexcept {
+		return policy_s{config::overflow, config::mismatch_is::skipped};
+	}
+};
+
+typedef policy_s<> policy;
+
+/**
+ * Lexer/scanner
+ * All parsing state is kept in the lexer and its stream. Lexers reading
+ * separate streams may be used concurrently (from different threads, or
+ * from an ISR and the main loop) if either temporary is configured
+ * _automatic, or the lexer is given its own scratch buffer for names.
+ * With the default static temporary all such lexers share one buffer.
+ */
+struct lexer : noncopyable, private policy {
+	inline lexer(istream& in, policy p = policy::of()) noexcept
+	  : policy(p), stream(in), name(own), namesize(own.size), heap(nullptr),
+		hold(0), blocked(! readable(in)) {}
+	/** lexer reading member names into the caller supplied scratch buffer */
+	template<size_t N>
+	inline lexer(istream& in, char_t (&scratch)[N],
+			policy p = policy::of()) noexcept
+	  : policy(p), stream(in), name(scratch), namesize(N), heap(nullptr),
+		hold(0), blocked(! readable(in)) {}
+	inline lexer(istream& in, char_t* scratch, size_t size,
+			policy p = policy::of()) noexcept
+	  : policy(p), stream(in), name(scratch), namesize(size),
+		heap(nullptr), hold(0), blocked(! readable(in)) {}
+	/** parsing rules of this lexer, a base so that constant ones take
+	 *  no space															*/
+	inline const policy& rules() const noexcept { return *this; }
+	/** arena for strings that can not be read as views, may be null		*/
+	inline arena* memory() const noexcept { return heap; }
+	inline void memory(arena* a) noexcept { heap = a; }
 
 	static inline void char_typify(
 		void (*add)(const char * str,ctype traits)noexcept) noexcept {
@@ -762,6 +1136,25 @@ struct lexer : noncopyable {
 
 	/** reads string markup, returns true on success						*/
 	ctype string(char_t& dst, bool first) noexcept;
+	/**
+	 * reads string as a view into the inline window of the stream.
+	 * Escaped strings are decoded in place if the window is writable,
+	 * otherwise, as well as strings not in the window, they are placed
+	 * in the arena. Without an arena such strings set noobject
+	 */
+	bool string(view& dst) noexcept;
+	/**
+	 * reads remainder of a string, which opening quote is already read,
+	 * as a view into the inline window if it is there entirely and has no
+	 * escapes. Otherwise returns false, leaving the stream intact
+	 */
+	bool plain(view& dst) noexcept;
+	/**
+	 * length of remainder of a string, which opening quote is already read
+	 * or held back, with escapes as in the input, if it ends in the window,
+	 * otherwise 0. An upper bound of the decoded length
+	 */
+	size_t remainder() const noexcept;
 	/** scans number, returns a type of symbol read							*/
 
 	inline ctype get(char_t& dst, ctype mask) noexcept {
@@ -792,7 +1185,26 @@ struct lexer : noncopyable {
 	bool skip(bool list=false) noexcept;
 	/** skips string or remainder of such 									*/
 	bool skip_string(bool first) noexcept;
-	inline void error(error_t e) noexcept { stream.error(e); }
+	/**
+	 * reads a JSON array of up to n integers or doubles straight from the
+	 * inline window of the stream into dst. Returns false, leaving the
+	 * stream intact, if the array is not entirely in the window or holds
+	 * anything but plain numbers, so that the caller may read it in generic
+	 * way. Items of dst may be altered even then
+	 */
+	template<typename T>
+	inline bool numbers(T* dst, size_t n) noexcept {
+		return numbers(dst, n, scanned<T>());
+	}
+	/**
+	 * counts items of the JSON array ahead, if it is entirely in the inline
+	 * window of the stream, otherwise returns 0. The stream is left intact
+	 */
+	size_t extent() const noexcept;
+	inline void error(error_t e) noexcept {
+		stream.error(e);
+		blocked = blocked || (e & blocking()) != error_t::noerror;
+	}
 	inline error_t error() const noexcept {
 		/* eof is not a lexer error */
 		return	static_cast<error_t>(stream.error() & ~error_t::eof);
@@ -816,8 +1228,11 @@ struct lexer : noncopyable {
 		return c == iostate::eos_c ? ctype::eof : ctype::err;
 	}
 
+	/** resets lexer state and syncs it with the stream. A blocked lexer
+	 * also resyncs on its own once the stream is cleared					*/
 	inline void restart() noexcept {
 		hold = 0;
+		blocked = ! readable(stream);
 	}
 
 	inline void back(char_t chr) noexcept {
@@ -829,6 +1244,20 @@ struct lexer : noncopyable {
 	}
 
 private:
+	/** errors that stop reading										*/
+	inline error_t blocking() const noexcept {
+		return rules().mismatch == config::mismatch_is::error ?
+			error_t::blocked : error_t::failed;
+	}
+	inline bool readable(const istream& in) const noexcept {
+		return (in.error() & blocking()) == error_t::noerror;
+	}
+	template<typename T>
+	static inline bool numbers(T*, size_t, std::false_type) noexcept {
+		return false;
+	}
+	template<typename T>
+	bool numbers(T* dst, size_t n, std::true_type) noexcept;
 	ctype unescape(char_t& chr ) noexcept;
 	ctype unhex(char_t& chr) noexcept;
 	ctype get(char_t& dst) noexcept;
@@ -840,22 +1269,202 @@ private:
 
 private:
 	istream& stream;
-	temporary name;
+	temporary own;
+	char_t* const name;
+	const size_t namesize;
+	arena* heap;
 	char_t hold;
+	/* stream error state is cached here and synced on transitions only,
+	 * to keep virtual error() calls out of the per-character path. While
+	 * set, it is re-checked on the slow path, so that a stream cleared by
+	 * the caller is read again without restart()						*/
+	bool blocked;
+};
+
+/**
+ * digits - scanning of plain numbers in a window of characters, used for
+ * reading arrays of numbers in a tight loop
+ */
+struct digits {
+	static inline const char_t* spaces(const char_t* p,
+			const char_t* e) noexcept {
+		while( p != e && (*p == literal::ws || *p == '\n' ||
+				*p == '\r' || *p == '\t') ) ++p;
+		return p;
+	}
+	static inline bool isnum(char_t c) noexcept {
+		return static_cast<unsigned>(c - literal::digit0) < 10;
+	}
+	/**
+	 * on 64-bit hosts with single-byte char_t converts eight digits at p,
+	 * if there are so many, with SWAR arithmetic
+	 */
+	static inline bool eight(const char_t* p, const char_t* e,
+			uint_fast32_t& val) noexcept {
+		if( sizeof(char_t) != 1 || sizeof(void*) < 8 || e - p < 8 )
+			return false;
+		uint64_t v = 0;
+		for(int i = 0; i < 8; ++i)
+			v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i]))
+				<< (8 * i);
+		if( ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+			(((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+				!= 0x3333333333333333ULL )
+			return false;
+		v -= 0x3030303030303030ULL;
+		v = (v * 10) + (v >> 8);
+		v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+			 (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))))
+				>> 32;
+		val = static_cast<uint_fast32_t>(v);
+		return true;
+	}
+	/**
+	 * scans integer at p, returns position past it, or nullptr if there
+	 * is no integer, it overflows, or is not followed by a delimiter
+	 */
+	template<typename T>
+	static const char_t* scan(const char_t* p, const char_t* e,
+			T& dst) noexcept {
+		typedef typename std::make_unsigned<T>::type U;
+		const bool neg = std::is_signed<T>::value && p != e &&
+			*p == literal::minus;
+		if( neg ) ++p;
+		const U limit = static_cast<U>(
+			static_cast<U>(std::numeric_limits<T>::max()) + (neg ? 1 : 0));
+		const char_t* b = p;
+		U val = 0;
+		uint_fast32_t eight_digits = 0;
+		while( sizeof(U) >= 4 && eight(p, e, eight_digits) ) {
+			if( val > (limit - eight_digits) / 100000000UL ) return nullptr;
+			val = static_cast<U>(val * 100000000UL + eight_digits);
+			p += 8;
+		}
+		for(; p != e && isnum(*p); ++p) {
+			U digit = static_cast<U>(*p - literal::digit0);
+			if( val > (limit - digit) / 10 ) return nullptr;
+			val = static_cast<U>(val * 10 + digit);
+		}
+		if( p == b || p == e ) return nullptr;
+		switch( *p ) {
+		case literal::value_separator:
+		case literal::end_array:
+		case literal::ws: case '\n': case '\r': case '\t':
+			break;
+		default:
+			return nullptr;
+		}
+		dst = neg ? static_cast<T>(0 - val) : static_cast<T>(val);
+		return p;
+	}
+	/**
+	 * scans double at p, as reader<double> does, but without per-character
+	 * calls to the lexer. Returns position past it, or nullptr if it is
+	 * malformed or is not followed by a delimiter
+	 */
+	static const char_t* scan(const char_t* p, const char_t* e,
+		double& dst) noexcept;
+	/**
+	 * writes n integers at src as a comma-separated list. Values are
+	 * formatted two digits at a time into a local buffer, which is written
+	 * out in spans
+	 */
+	template<typename T>
+	static bool write(const T* src, size_t n, ostream& out,
+			std::true_type) noexcept {
+		typedef typename numeric_helper<T>::U U;
+		/* digits, sign and separator */
+		static constexpr size_t width = std::numeric_limits<U>::digits10 + 3;
+		char_t buf[width > 32 ? width * 2 : 64];
+		size_t len = 0;
+		for(size_t i = 0; i < n; ++i) {
+			if( sizeof(buf) / sizeof(buf[0]) - len < width ) {
+				if( ! out.emit(buf, len) ) return false;
+				len = 0;
+			}
+			if( i ) buf[len++] = literal::value_separator;
+			len += format(buf + len, src[i]);
+		}
+		return out.emit(buf, len);
+	}
+	template<typename T>
+	static inline bool write(const T*, size_t, ostream&,
+			std::false_type) noexcept {
+		return false;
+	}
+	/** formats val at dst, returns number of characters written			*/
+	template<typename T>
+	static size_t format(char_t* dst, T val) noexcept {
+		typedef numeric_helper<T> H;
+		typedef typename H::U U;
+		static constexpr size_t size = std::numeric_limits<U>::digits10 + 1;
+		char_t tmp[size];
+		size_t p = size, n = 0;
+		U v = H::is_negative(val) ? U(0) - static_cast<U>(val)
+								  : static_cast<U>(val);
+		for(; v >= 100; v /= 100) {
+			const unsigned d = static_cast<unsigned>(v % 100) * 2;
+			tmp[--p] = pairs<>::text[d + 1];
+			tmp[--p] = pairs<>::text[d];
+		}
+		if( v >= 10 ) {
+			tmp[--p] = pairs<>::text[v * 2 + 1];
+			tmp[--p] = pairs<>::text[v * 2];
+		} else
+			tmp[--p] = static_cast<char_t>(literal::digit0 + v);
+		if( H::is_negative(val) ) dst[n++] = literal::minus;
+		while( p < size ) dst[n++] = tmp[p++];
+		return n;
+	}
+	/** "00" to "99", a template to be emitted only if used					*/
+	template<bool = true>
+	struct pairs {
+		static constexpr char text[] =
+			"00010203040506070809101112131415161718192021222324"
+			"25262728293031323334353637383940414243444546474849"
+			"50515253545556575859606162636465666768697071727374"
+			"75767778798081828384858687888990919293949596979899";
+	};
 };
 
+template<bool B>
+constexpr char digits::pairs<B>::text[];
+
+template<typename T>
+bool lexer::numbers(T* dst, size_t n, std::true_type) noexcept {
+	if( blocked || hold ) return false;
+	const char_t* const e = stream.gend;
+	const char_t* p = digits::spaces(stream.gnext, e);
+	if( p == e || *p != literal::begin_array ) return false;
+	p = digits::spaces(p + 1, e);
+	if( p != e && *p == literal::end_array ) {
+		stream.gnext = p + 1;
+		return true;
+	}
+	for(size_t i = 0; i < n; ++i) {
+		if( (p = digits::scan(p, e, dst[i])) == nullptr ) return false;
+		p = digits::spaces(p, e);
+		if( p == e ) return false;
+		if( *p == literal::end_array ) {
+			stream.gnext = p + 1;
+			return true;
+		}
+		if( *p != literal::value_separator ) return false;
+		p = digits::spaces(p + 1, e);
+	}
+	return false;
+}
+
 /******************************************************************************/
 /* multiplication by 10 with saturation on overflow */
-template<typename T>
-static inline bool tenfold(T& val, T digit) noexcept {
+template<typename T, class P = policy>
+static inline bool tenfold(T& val, T digit, const P& rules = P()) noexcept {
 	static constexpr T max = std::numeric_limits<T>::max() / 10;
 	static constexpr T mxd = std::numeric_limits<T>::max() % 10;
 	static constexpr T min = std::numeric_limits<T>::min() / 10;
 	static constexpr T mnd = std::numeric_limits<T>::min() % 10;
-	static constexpr bool overflow_check =
-			config::overflow != config::overflow_is::ignored;
-	static constexpr bool saturation  =
-			config::overflow == config::overflow_is::saturated;
+	const bool overflow_check = rules.overflow != config::overflow_is::ignored;
+	const bool saturation = rules.overflow == config::overflow_is::saturated;
 	if( overflow_check && std::is_signed<T>::value ) {
 		if( val < min || (val == min && digit < mnd) ) {
 			val = std::numeric_limits<T>::min();
@@ -890,6 +1499,7 @@ struct reader {
 		 */
 		char_t digit = 0;
 		signed char sign = 0;
+		const policy rules = in.rules();
 		val = 0;
 		ctype ct;
 		if( ! isvalid(in.value(ctype::numeric)) ) return false;
@@ -908,7 +1518,8 @@ struct reader {
 		case ctype::digit:
 			digit -= literal::digit0;
 			if( ! sign ) sign = 1;
-			if( tenfold<T>(val, (sign > 0 ? digit : -digit)) ) continue;
+			if( tenfold<T>(val, (sign > 0 ? digit : -digit), rules) )
+				continue;
 			in.error(error_t::overflow);
 			return in.skip(ctype::number);
 		case ctype::sign:
@@ -933,6 +1544,118 @@ struct reader<char_t*> {
 	static bool read(char_t* dst, size_t n, lexer& in) noexcept;
 };
 
+/**
+ * symbol - handle of a string interned in a pool. Symbols of the same pool
+ * are equal if their pointers are equal
+ */
+struct symbol {
+	inline constexpr symbol() noexcept : str(nullptr) {}
+	explicit inline constexpr symbol(const char_t* s) noexcept : str(s) {}
+	inline constexpr const char_t* c_str() const noexcept { return str; }
+	inline constexpr bool null() const noexcept { return str == nullptr; }
+	inline constexpr bool operator==(const symbol& s) const noexcept {
+		return str == s.str;
+	}
+	inline constexpr bool operator!=(const symbol& s) const noexcept {
+		return str != s.str;
+	}
+private:
+	const char_t* str;
+};
+
+/**
+ * pool - set of interned strings. Strings are kept in an arena and indexed
+ * in an open addressing hash table of n slots, n is a power of two.
+ * While a string is lexed its characters are placed at the top of the
+ * arena and hashed, a repeated string then takes no memory
+ */
+class pool : noncopyable {
+public:
+	pool(const char_t** slots, size_t n, void* chars, size_t size) noexcept
+	  : table(slots), mask(n - 1), count(0), chars(chars, size),
+		hash(basis) {
+		clear();
+	}
+	/** appends a character to the string being interned				*/
+	inline bool put(char_t c) noexcept {
+		hash = mix(hash, c);
+		return chars.put(c);
+	}
+	/** interns the string put so far, returns null symbol if pool is full	*/
+	symbol take() noexcept;
+	/** discards the string put so far									*/
+	inline void drop() noexcept {
+		chars.drop();
+		hash = basis;
+	}
+	/** interns a zero-terminated string								*/
+	symbol intern(const char_t* str) noexcept {
+		while( *str && put(*str) ) ++str;
+		if( *str == 0 ) return take();
+		drop();
+		return symbol();
+	}
+	/** finds an interned string, returns null symbol if not found		*/
+	symbol find(const char_t* str) const noexcept;
+	/** removes all strings												*/
+	void clear() noexcept {
+		for(size_t i = 0; i <= mask; ++i) table[i] = nullptr;
+		count = 0;
+		chars.reset();
+		hash = basis;
+	}
+	inline size_t size() const noexcept { return count; }
+	/** reads a string value, interning it								*/
+	bool read(symbol& dst, lexer& in) noexcept;
+private:
+	static constexpr unsigned long basis = 2166136261UL;
+	static constexpr unsigned long prime = 16777619UL;
+	/** FNV-1a step														*/
+	static inline unsigned long mix(unsigned long h, char_t c) noexcept {
+		return ((h ^ static_cast<unsigned long>(c)) * prime) & 0xFFFFFFFFUL;
+	}
+	/** slot holding str or the empty one where it belongs, nullptr if full	*/
+	const char_t** slot(unsigned long h, const view& str) const noexcept;
+	const char_t** const table;
+	const size_t mask;
+	size_t count;
+	arena chars;
+	unsigned long hash;
+};
+
+/**
+ * pool with own storage for Slots strings of total length up to Chars,
+ * including terminators
+ */
+template<size_t Slots, size_t Chars>
+struct cells {
+	static_assert(Slots != 0 && (Slots & (Slots - 1)) == 0,
+		"Slots must be a power of two");
+	const char_t* index[Slots];
+	char_t text[Chars];
+};
+
+template<size_t Slots, size_t Chars>
+class symbols : private cells<Slots, Chars>, public pool {
+public:
+	inline symbols() noexcept : pool(this->index, Slots, this->text,
+		sizeof(this->text)) {}
+};
+
+template<>
+struct reader<view> {
+	static bool read(view& dst, lexer& in) noexcept {
+		ctype ct;
+		if( ! isvalid(ct=in.value(ctype::stringnull)) )
+			return in.skip();
+		if( ct == ctype::null ) {
+			dst = view();
+			return true;
+		}
+		return in.string(dst);
+	}
+};
+
 template<>
 struct reader<double> {
 	static bool read(double&, lexer&) noexcept;
@@ -975,12 +1698,12 @@ inline bool gfmt<char_t*, float>(char_t* b, size_t s, float v) noexcept {
 template<typename T>
 bool write_number(T val, bool negative, T divider, ostream& out) noexcept {
 	bool was = false;
-	if( negative && ! out.put(literal::minus) ) return false;
+	if( negative && ! out.emit(literal::minus) ) return false;
 	while( divider ) {
 		T digit = (val / divider) % 10;
 		divider /= 10;
 		if( digit || was || ! divider) {
-			if( ! out.put(literal::digit0 + digit) ) return false;
+			if( ! out.emit(literal::digit0 + digit) ) return false;
 			was = true;
 		}
 
@@ -1008,6 +1731,18 @@ struct writer<const char_t*> {
 	static bool write(char_t, ostream&) noexcept;
 };
 
+template<>
+struct writer<view> {
+	static bool write(const view& str, ostream& out) noexcept;
+};
+
+template<>
+struct writer<symbol> {
+	static inline bool write(const symbol& sym, ostream& out) noexcept {
+		return writer<const char_t*>::write(sym.c_str(), out);
+	}
+};
+
 template<>
 struct writer<progmem<char_t>> {
 	static bool write(progmem<char_t> s, ostream& o) noexcept;
@@ -1054,6 +1789,11 @@ static inline constexpr size_t countof(T (&)[N]) noexcept  { return N; }
 } /* namespace details */
 using lexer = details::lexer;
 using cstring = details::cstring;
+using view = details::view;
+using arena = details::arena;
+using symbol = details::symbol;
+using pool = details::pool;
+using details::symbols;
 
 namespace details {
 /**
@@ -1164,7 +1904,7 @@ struct collection {
  * JSON array
  */
 struct array : value {
-	inline array(const item* const itemlist, size_t length) noexcept
+	inline constexpr array(const item* const itemlist, size_t length) noexcept
 	: items(itemlist), size(length) {}
 
 	bool read(lexer& in) const noexcept {
@@ -1188,6 +1928,13 @@ struct array : value {
 		return out.put(literal::end_array);
 	}
 
+	/** write array of n integers at src in batches (see digits::write)	*/
+	template<typename T>
+	static inline bool numbers(const T* src, size_t n, ostream& out) noexcept {
+		return out.put(literal::begin_array)
+			&& digits::write(src, n, out, batched<T>()) && end(out);
+	}
+
 	/** write array implementation with item writing delegated to agent */
 	template<class A>
 	static inline bool write(const A& agent, ostream& out) noexcept {
@@ -1223,11 +1970,12 @@ private:
 /**
  * JSON member - a named element in an object
  */
-struct member {
+struct member : prefixed<> {
 private:
 	template<class C> friend struct property;
 	template<class C> friend struct clas;
 	friend class object;
+	friend struct schema;
 
 	virtual cstring name() const noexcept = 0;
 	virtual bool readval(lexer&) const noexcept = 0;
@@ -1237,8 +1985,18 @@ private:
 		return writer<cstring>::write(name, out)
 			&& out.put(literal::name_separator);
 	}
-	inline bool prolog(ostream& out) const noexcept {
-		return prolog(name(), out);
+	/** writes object delimiter and name of member m, as a single fragment
+	 * if m provides it 													*/
+	template<class M>
+	static inline bool prolog(bool first, const M& m, ostream& out) noexcept {
+		const fragment pre(m.prefix());
+		if( pre.empty() )
+			return out.put(first ?
+						literal::begin_object : literal::value_separator)
+				&& prolog(m.name(), out);
+		return first ?
+			out.put(literal::begin_object) && out.write(pre.str+1, pre.len-1)
+		  : out.write(pre.str, pre.len);
 	}
 	inline bool match(const char_t* aname) const noexcept {
 		return details::match(name(),aname);
@@ -1249,7 +2007,8 @@ private:
  * JSON object - a collection of members
  */
 struct object : value {
-	object(const node* list, size_t length) : nodes(list), size(length) {}
+	constexpr object(const node* list, size_t length) noexcept
+	  : nodes(list), size(length) {}
 	bool read(lexer& in) const noexcept {
 		return collection<indexer>::read(*this,void_v,in);
 	}
@@ -1268,11 +2027,131 @@ private:
 	const size_t size;
 };
 
+/**
+ * selector - reads values at given JSON Pointer paths (RFC 6901) without
+ * a schema for the rest of the document, e.g.
+ * static const selector::path paths[] = {
+ *		{ "/wan/ipaddr/0",	V<16, ipaddr> },
+ *		{ "/wifinets/" "*" "/networks/" "*" "/ssid", V<32, ssid> }
+ * };
+ * selector(paths).read(in);
+ * A segment * matches any member or item. Each path is bound to a value,
+ * that reads the first match of a plain path and every match of a path
+ * with wildcards. Everything else is skipped, reading stops as soon as all
+ * plain paths are matched, unless there are paths with wildcards.
+ * A value can be read only once, therefore paths that may select the same
+ * value, or one a value within another, are rejected: read fails with
+ * error_t::bad. So are paths with ~ not followed by 0 or 1. An index with
+ * leading zeros, such as 01, matches no array item.
+ * Skipping requires a lexer with mismatch_is::skipped rules. read(istream&)
+ * makes one, unless the policy is per build, then the build rules apply
+ */
+class selector {
+public:
+	struct path {
+		cstring pointer;
+		item target;
+	};
+	template<size_t N>
+	inline selector(const path (&list)[N]) noexcept
+	  : paths(list), count(N), plain(plains(list, N)),
+		sound(! malformed(list, N) && ! overlapping(list, N)) {
+		static_assert(N <= sizeof(mask) * 8, "too many paths");
+	}
+	bool read(lexer& in) const noexcept;
+	bool read(istream& in) const noexcept;
+private:
+	typedef unsigned long mask;
+	static inline constexpr mask bit(size_t i) noexcept {
+		return static_cast<mask>(1) << i;
+	}
+	static mask plains(const path* list, size_t n) noexcept;
+	static bool malformed(const path* list, size_t n) noexcept;
+	static bool overlapping(const path* list, size_t n) noexcept;
+	bool walk(lexer& in, mask alive, size_t depth, mask& done) const noexcept;
+	bool members(lexer& in, mask alive, size_t depth,
+		mask& done) const noexcept;
+	bool items(lexer& in, mask alive, size_t depth, mask& done) const noexcept;
+	/** all paths are plain and matched									*/
+	inline bool complete(mask done) const noexcept {
+		return (done & plain) == plain && plain == (count < sizeof(mask) * 8 ?
+			bit(count) - 1 : ~static_cast<mask>(0));
+	}
+	const path* const paths;
+	const size_t count;
+	const mask plain;
+	const bool sound;
+};
+
+/**
+ * composer - compiles output of a class into an outline: a sequence of
+ * constant JSON fragments, merged together, interleaved with value writers.
+ * Literal text is collected with put/write, values are recorded with value
+ * as offsets from the object the outline is compiled for.
+ */
+class composer : public ostream {
+public:
+	typedef bool (*writer_f)(const void* item, const void* val, ostream&);
+	struct step {
+		size_t end;			/* end of the literal text preceding the value	*/
+		writer_f write;		/* value writer									*/
+		const void* item;	/* writer's context, e.g. property				*/
+		size_t offset;		/* offset of the value in the object			*/
+	};
+	inline composer(step* s, size_t ns, char_t* t, size_t nt) noexcept
+	  : steps(s), text(t), maxsteps(ns), maxtext(nt),
+		count(0), length(0), origin(nullptr), state(state_t::fresh) {}
+	bool put(char_t c) noexcept;
+	bool write(const char_t* s, size_t n) noexcept;
+	/** records writer w for a value at val with context item 				*/
+	bool value(writer_f w, const void* item, const void* val) noexcept;
+	/** records a scalar value val 											*/
+	template<typename T>
+	inline bool value(const T& val) noexcept {
+		return value(&scalar<T>, nullptr, &val);
+	}
+	/** records an opaque property p of object obj							*/
+	template<class C>
+	inline bool value(const property<C>& p, const C& obj) noexcept {
+		return value(&opaque<C>, &p, &obj);
+	}
+	inline bool compiled() const noexcept {
+		return state == state_t::ready;
+	}
+	inline bool failed() const noexcept {
+		return state == state_t::failed;
+	}
+protected:
+	bool begin(const void* obj) noexcept;
+	bool end(bool success) noexcept;
+	/** writes object obj using the compiled outline						*/
+	bool run(const void* obj, ostream& out) const noexcept;
+private:
+	template<typename T>
+	static bool scalar(const void*, const void* val, ostream& out) noexcept {
+		return writer<T>::write(*static_cast<const T*>(val), out);
+	}
+	template<class C>
+	static bool opaque(const void* p, const void* obj, ostream& out) noexcept {
+		return static_cast<const property<C>*>(p)->write(
+			*static_cast<const C*>(obj), out);
+	}
+	enum class state_t : unsigned char { fresh, ready, failed };
+	step* const steps;
+	char_t* const text;
+	const size_t maxsteps;
+	const size_t maxtext;
+	size_t count;
+	size_t length;
+	const char* origin;
+	state_t state;
+};
+
 /**
  * property - a named property of c++ class or structure
  */
 template<class C>
-struct property : noncopyable {
+struct property : noncopyable, prefixed<> {
 	/* property cannot be derived from value or member because of its
 	 * high connection to the class instance
 	 */
@@ -1280,6 +2159,10 @@ struct property : noncopyable {
 	virtual cstring name() const noexcept = 0;
 	virtual bool read(C& obj, lexer&) const noexcept = 0;
 	virtual bool write(const C& obj, ostream&) const noexcept = 0;
+	/** compiles property into an outline, by default as an opaque value	*/
+	virtual bool compile(composer& out, const C& obj) const noexcept {
+		return out.value(*this, obj);
+	}
 	inline bool match(const char_t* aname) const noexcept {
 		return details::match(name(),aname);
 	}
@@ -1294,7 +2177,7 @@ struct property : noncopyable {
 template<class C>
 struct clas : noncopyable {
 	typedef typename property<C>::node node;
-	clas(const node * n, size_t s) noexcept : nodes(n), size(s) { }
+	constexpr clas(const node * n, size_t s) noexcept : nodes(n), size(s) { }
 	bool read(C& obj, lexer& in) const noexcept {
 		return collection<indexer>::read(*this, obj, in);
 	}
@@ -1302,12 +2185,26 @@ struct clas : noncopyable {
 		bool r = true;
 		for(size_t i = 0; i < size && r; ++i) {
 			const property<C>& prop(nodes[i]());
-			r = object::dlm(i==0, out) 			&&
-				member::prolog(prop.name(), out)&&
+			r = member::prolog(i==0, prop, out) &&
 				prop.write(obj, out);
 		}
 		return r && object::end(out);
 	}
+	/** reads obj from stream in with a lexer of its own					*/
+	inline bool read(C& obj, istream& in) const noexcept {
+		lexer lex(in);
+		return read(obj, lex);
+	}
+	/** compiles output of obj into outline out 							*/
+	bool compile(composer& out, const C& obj) const noexcept {
+		bool r = true;
+		for(size_t i = 0; i < size && r; ++i) {
+			const property<C>& prop(nodes[i]());
+			r = member::prolog(i==0, prop, out) &&
+				prop.compile(out, obj);
+		}
+		return r && object::end(out);
+	}
 	static inline constexpr bool null(C&) noexcept {
 		return config::null_is_error;
 	}
@@ -1328,24 +2225,215 @@ protected:
 };
 
 /**
- * scalar value read/write implementation based on externalized accessor X
+ * outline - precompiled output of class C with structure S, holding
+ * up to N value writers and L characters of merged literal text.
+ * The outline is compiled on first write, or explicitly with compile.
+ * If it does not fit, writing falls back to S.write
  */
-template<class X>
-struct scalar : value {
-	typedef typename X::type T;
-	bool read(lexer& in) const noexcept {
-		if( X::canlref && X::has() ) {
-			return reader<T>::read(X::lref(), in);
-		} else if( X::canset ) {
-			T v;
-			X::init(v);
-			if( reader<T>::read(v, in) ) {
-				X::set(v);
-				return true;
-			} else
-				return false;
-		} else {
-			in.error(error_t::noobject);
+template<class C, size_t N, size_t L>
+class outline : public composer {
+public:
+	inline outline(const clas<C>& s) noexcept
+	  : composer(steps, N, text, L), structure(s) {}
+	/** compiles outline for layout of obj, returns false if it did not fit	*/
+	bool compile(const C& obj) noexcept {
+		return end(begin(&obj) && structure.compile(*this, obj));
+	}
+	bool write(const C& obj, ostream& out) noexcept {
+		if( ! compiled() && ( failed() || ! compile(obj) ) )
+			return structure.write(obj, out);
+		return run(&obj, out);
+	}
+private:
+	const clas<C>& structure;
+	step steps[N];
+	char_t text[L];
+};
+
+/** function returning prebuilt name prefix, see prefix<id>				*/
+typedef fragment (*prefixer)();
+
+/**
+ * member name and prefix as kept in descriptors - the text itself, so that
+ * the schema engine reads them without calls, or, for progmem names, which
+ * are not constant expressions, the functions returning them
+ */
+template<bool = config::cstring == config::cstring_is::avr_progmem>
+struct caption {
+	typedef cstring  label;
+	typedef fragment affix;
+	static inline constexpr label of(name id) noexcept { return id(); }
+	template<name id>
+	static inline constexpr affix prefix() noexcept {
+		return details::prefix<id>::get();
+	}
+	static inline constexpr affix none() noexcept {
+		return fragment{nullptr, 0};
+	}
+	static inline cstring text(label l) noexcept { return l; }
+	static inline fragment text(affix a) noexcept { return a; }
+};
+
+template<>
+struct caption<true> {
+	typedef name     label;
+	typedef prefixer affix;
+	static inline constexpr label of(name id) noexcept { return id; }
+	template<name id>
+	static inline constexpr affix prefix() noexcept {
+		return details::prefix<id>::get;
+	}
+	static inline constexpr affix none() noexcept { return nullptr; }
+	static inline cstring text(label l) noexcept { return l(); }
+	static inline fragment text(affix a) noexcept {
+		return a ? a() : fragment{nullptr, 0};
+	}
+};
+
+/**
+ * descriptor - an entry of a table-driven schema, describing a member of
+ * a class by its name, kind and offset. Tables of descriptors are constant
+ * and are interpreted by a single engine, schema, without virtual calls
+ */
+struct descriptor {
+	enum class kind_t : unsigned char {
+		none, boolean, i8, u8, i16, u16, i32, u32, i64, u64, f32, f64,
+		string, object, array
+	};
+	caption<>::label id;		/* member name								*/
+	kind_t kind;				/* member kind								*/
+	kind_t item;				/* kind of array item						*/
+	size_t offset;				/* offset of the member in the object		*/
+	size_t count;				/* array length or string buffer size		*/
+	size_t stride;				/* size of the member or array item			*/
+	const descriptor* nested;	/* table of nested object(s)				*/
+	size_t size;				/* size of the nested table					*/
+	caption<>::affix prefix;	/* prebuilt name prefix, if any				*/
+
+	static inline constexpr kind_t integral(size_t n, bool sign) noexcept {
+		return
+			n == 1 ? (sign ? kind_t::i8  : kind_t::u8)  :
+			n == 2 ? (sign ? kind_t::i16 : kind_t::u16) :
+			n == 4 ? (sign ? kind_t::i32 : kind_t::u32) :
+			n == 8 ? (sign ? kind_t::i64 : kind_t::u64) : kind_t::none;
+	}
+	/** kind of a scalar or a class type T									*/
+	template<typename T>
+	static inline constexpr kind_t of() noexcept {
+		return
+			std::is_same<T, bool>::value ? kind_t::boolean :
+			std::is_integral<T>::value ?
+				integral(sizeof(T), std::is_signed<T>::value) :
+			std::is_floating_point<T>::value ?
+				( sizeof(T) == sizeof(float)  ? kind_t::f32 :
+				  sizeof(T) == sizeof(double) ? kind_t::f64 : kind_t::none) :
+			std::is_class<T>::value ? kind_t::object : kind_t::none;
+	}
+};
+
+/** descriptor builder for a member of type T								*/
+template<typename T>
+struct describe {
+	static_assert(descriptor::of<T>() != descriptor::kind_t::none,
+		"Type is not supported by table-driven schema");
+	static inline constexpr descriptor make(name id, size_t offset,
+			const descriptor* nested, size_t size,
+			caption<>::affix pre = caption<>::none()) noexcept {
+		return descriptor{caption<>::of(id), descriptor::of<T>(),
+			descriptor::kind_t::none, offset, 0, sizeof(T), nested, size, pre};
+	}
+};
+
+/** descriptor builder for a string member char_t[N]						*/
+template<size_t N>
+struct describe<char_t[N]> {
+	static inline constexpr descriptor make(name id, size_t offset,
+			const descriptor*, size_t,
+			caption<>::affix pre = caption<>::none()) noexcept {
+		return descriptor{caption<>::of(id), descriptor::kind_t::string,
+			descriptor::kind_t::none, offset, N, sizeof(char_t[N]),
+			nullptr, 0, pre};
+	}
+};
+
+/** descriptor builder for an array member T[N]							*/
+template<typename T, size_t N>
+struct describe<T[N]> {
+	static constexpr descriptor::kind_t item =
+		std::is_array<T>::value && std::is_same<
+			typename std::remove_extent<T>::type, char_t>::value ?
+			descriptor::kind_t::string : descriptor::of<T>();
+	static_assert(item != descriptor::kind_t::none,
+		"Array item type is not supported by table-driven schema");
+	static inline constexpr descriptor make(name id, size_t offset,
+			const descriptor* nested, size_t size,
+			caption<>::affix pre = caption<>::none()) noexcept {
+		return descriptor{caption<>::of(id), descriptor::kind_t::array, item,
+			offset, N, sizeof(T), nested, size, pre};
+	}
+};
+
+/**
+ * schema - the engine interpreting a table of descriptors
+ */
+struct schema {
+	inline constexpr schema(const descriptor* t, size_t n) noexcept
+	  : table(t), size(n) {}
+	template<size_t N>
+	inline constexpr schema(const descriptor (&t)[N]) noexcept
+	  : table(t), size(N) {}
+	bool read(void* obj, lexer& in) const noexcept;
+	bool write(const void* obj, ostream& out) const noexcept;
+	/** reads value of kind k, described with d, into dst					*/
+	static bool read(const descriptor& d, descriptor::kind_t k,
+			char* dst, lexer& in) noexcept;
+	/** writes value of kind k, described with d, from src					*/
+	static bool write(const descriptor& d, descriptor::kind_t k,
+			const char* src, ostream& out) noexcept;
+	static inline constexpr bool null(char*) noexcept {
+		return config::null_is_error;
+	}
+private:
+	friend class collection<indexer>;
+	bool read(char* obj, lexer& in, const char_t* name) const noexcept;
+	const descriptor* const table;
+	const size_t size;
+};
+
+/**
+ * table - a table-driven schema for class C
+ */
+template<class C>
+struct table : schema {
+	template<size_t N>
+	inline constexpr table(const descriptor (&t)[N]) noexcept : schema(t) {}
+	inline bool read(C& obj, lexer& in) const noexcept {
+		return schema::read(&obj, in);
+	}
+	inline bool write(const C& obj, ostream& out) const noexcept {
+		return schema::write(&obj, out);
+	}
+};
+
+/**
+ * scalar value read/write implementation based on externalized accessor X
+ */
+template<class X>
+struct scalar : value {
+	typedef typename X::type T;
+	bool read(lexer& in) const noexcept {
+		if( X::canlref && X::has() ) {
+			return reader<T>::read(X::lref(), in);
+		} else if( X::canset ) {
+			T v;
+			X::init(v);
+			if( reader<T>::read(v, in) ) {
+				X::set(v);
+				return true;
+			} else
+				return false;
+		} else {
+			in.error(error_t::noobject);
 			return in.skip();
 		}
 	}
@@ -1369,26 +2457,35 @@ struct scalar : value {
  * string value implementation
  */
 struct string : value {
-	inline string(char_t* s, size_t length) noexcept
+	inline constexpr string(char_t* s, size_t length) noexcept
 	  : str(s), size(length) {}
-	inline string(const char_t* s) noexcept
+	inline constexpr string(const char_t* s) noexcept
 	  : str(const_cast<char_t*>(s)), size(0) {}
 	bool read(lexer& in) const noexcept {
+		return read(str, size, in);
+	}
+	bool write(ostream& out) const noexcept {
+		return write(str, out);
+	}
+	inline bool null() const noexcept {
+		return null(str);
+	}
+	static bool read(char_t* str, size_t size, lexer& in) noexcept {
 		ctype ct;
 		if( ! isvalid(ct=in.value(ctype::stringnull)) )
 			return in.skip();
 		if( ct == ctype::null ) {
-			if( null() ) return true;
+			if( null(str) ) return true;
 			in.error(error_t::mismatch);
 			return false;
 		}
 		return reader<char_t*>::read(str, size, in);
 	}
-	bool write(ostream& out) const noexcept {
+	static bool write(const char_t* str, ostream& out) noexcept {
 		return str != nullptr ?
-			writer<char_t*>::write(str, out) : value::null(out);
+			writer<const char_t*>::write(str, out) : value::null(out);
 	}
-	inline bool null() const noexcept {
+	static inline bool null(char_t* str) noexcept {
 		if( str != nullptr )
 			*str = 0;
 		return true;
@@ -1399,6 +2496,20 @@ private:
 	const size_t size;
 };
 
+/**
+ * string value bound to a buffer of N char_t returned by function F.
+ * F is called on each access, so the value needs no runtime construction
+ */
+template<typename T, T* (*F)() noexcept, size_t N = 0>
+struct stringf : value {
+	bool read(lexer& in) const noexcept {
+		return string::read(const_cast<char_t*>(F()), N, in);
+	}
+	bool write(ostream& out) const noexcept {
+		return string::write(F(), out);
+	}
+};
+
 /**
  * property read/write implementation based on externalized accessor X
  */
@@ -1438,8 +2549,12 @@ struct propertyx : property<typename X::clas> {
 template<class X>
 struct vector : value {
 	typedef typename X::type T;
+	/** number of contiguous items, if X declares it						*/
+	static constexpr size_t extent = detectors::extent_of<X>::value;
 	/** read array */
 	bool read(lexer& in) const noexcept {
+		if( extent && X::canlref && in.numbers(&X::lref(0), extent) )
+			return true;
 		if( X::canset || X::canlref )
 			return collection<>::read(*this, void_v, in);
 		else {
@@ -1448,6 +2563,8 @@ struct vector : value {
 		}
 	}
 	bool write(ostream& out) const noexcept {
+		if( batched<T>::value && extent && X::canrref )
+			return array::numbers(&X::rref(0), extent, out);
 		if( X::canget || X::canrref )
 			return array::write(*this, out);
 		else
@@ -1564,16 +2681,278 @@ struct objects
 		objectlist<X,S>, objectval<X,S>>::type {
 };
 
+#if __cpp_constexpr >= 201304
+/**
+ * constant - compile-time parsing of JSON literals into literal classes,
+ * driven by a type-level schema of K<> fields (see cojson::preset).
+ * Parsing is strict: a malformed literal, an integer overflow or a
+ * string overrun fails the constant evaluation
+ */
+namespace constant {
+
+/** not constexpr, reaching it fails compile-time evaluation				*/
+inline void json_literal_is_malformed() noexcept {}
+
+/** reading position in a JSON literal										*/
+struct cursor {
+	const char_t* at;
+	const char_t* end;
+
+	constexpr cursor(const char_t* b, const char_t* e) noexcept
+	  : at(b), end(e) {}
+
+	constexpr bool fail() noexcept {
+		if( end ) json_literal_is_malformed();
+		at = end;
+		return false;
+	}
+	/** skips whitespaces and returns next character or 0 at the end	*/
+	constexpr char_t peek() noexcept {
+		while( at < end && (*at == literal::ws || *at == '\t' ||
+				*at == '\n' || *at == '\r') ) ++at;
+		return at < end ? *at : 0;
+	}
+	/** consumes character c, if it is the next one						*/
+	constexpr bool accept(char_t c) noexcept {
+		return peek() == c ? (++at, true) : false;
+	}
+	/** consumes character c, failing if it is not the next one			*/
+	constexpr bool expect(char_t c) noexcept {
+		return accept(c) || fail();
+	}
+	constexpr bool digit() const noexcept {
+		return at < end && *at >= literal::digit0 && *at <= '9';
+	}
+	/** consumes literal w, if it is the next one						*/
+	constexpr bool word(const char* w) noexcept {
+		if( peek() != *w ) return false;
+		while( *w && at < end && *at == *w ) ++at, ++w;
+		return *w == 0 || fail();
+	}
+	constexpr bool null() noexcept {
+		return word("null");
+	}
+	constexpr bool unescape(char_t& chr) noexcept {
+		if( at >= end ) return fail();
+		chr = *at++;
+		if( literal::is_escaped(chr) ) return true;
+		for(size_t i = 0; i < countof(literal::replacement); ++i)
+			if( chr == literal::replacement[i] )
+				return (chr = literal::common[i]), true;
+		if( chr != literal::hex_mark ) return fail();
+		chr = 0;
+		for(int n = 0; n < 4; ++n, ++at) {
+			if( at >= end ) return fail();
+			char_t c = *at;
+			int v = c >= literal::digit0 && c <= '9' ? c - literal::digit0
+				  : c >= literal::digitA && c <= 'F' ? c - literal::digitA + 10
+				  : c >= literal::digita && c <= 'f' ? c - literal::digita + 10
+				  : -1;
+			if( v < 0 ) return fail();
+			chr = (chr << 4) | v;
+		}
+		return true;
+	}
+	/** reads string to dst of size n, or skips it if dst is null		*/
+	constexpr bool string(char_t* dst, size_t n) noexcept {
+		if( ! expect(literal::quotation_mark) ) return false;
+		size_t i = 0;
+		while( at < end && *at != literal::quotation_mark ) {
+			char_t chr = *at++;
+			if( chr == literal::escape && ! unescape(chr) ) return false;
+			if( dst == nullptr ) continue;
+			if( i + 1 >= n ) return fail();
+			dst[i++] = chr;
+		}
+		if( at >= end ) return fail();
+		++at;
+		if( dst ) dst[i] = 0;
+		return true;
+	}
+	/** reads member name, returning its (escaped) text in [b,e)		*/
+	constexpr bool key(const char_t*& b, const char_t*& e) noexcept {
+		if( peek() != literal::quotation_mark ) return fail();
+		b = at + 1;
+		if( ! string(nullptr, 0) ) return false;
+		e = at - 1;
+		return expect(literal::name_separator);
+	}
+	constexpr bool number(bool& dst) noexcept {
+		return word("true") ? (dst = true) :
+			   word("false") ? !(dst = false) : fail();
+	}
+	template<typename T>
+	constexpr bool number(T& dst) noexcept {
+		return std::is_floating_point<T>::value ? real(dst) : integer(dst);
+	}
+	template<typename T>
+	constexpr bool integer(T& dst) noexcept {
+		const bool neg = std::is_signed<T>::value && accept(literal::minus);
+		if( ! (peek() && digit()) ) return fail();
+		T val = 0;
+		while( digit() ) {
+			T d = static_cast<T>(*at++ - literal::digit0);
+			if( neg ? val < (std::numeric_limits<T>::min() + d) / 10
+					: val > (std::numeric_limits<T>::max() - d) / 10 )
+				return fail();
+			val = static_cast<T>(neg ? val * 10 - d : val * 10 + d);
+		}
+		if( at < end && (*at == literal::decimal || *at == 'e' || *at == 'E') )
+			return fail();
+		dst = val;
+		return true;
+	}
+	template<typename T>
+	constexpr bool real(T& dst) noexcept {
+		const bool neg = accept(literal::minus);
+		if( ! (peek() && digit()) ) return fail();
+		long double val = 0;
+		int exp = 0;
+		while( digit() ) val = val * 10 + (*at++ - literal::digit0);
+		if( at < end && *at == literal::decimal ) {
+			++at;
+			if( ! digit() ) return fail();
+			while( digit() ) val = val * 10 + (*at++ - literal::digit0), --exp;
+		}
+		if( at < end && (*at == 'e' || *at == 'E') ) {
+			++at;
+			const bool eneg = at < end && *at == literal::minus;
+			if( at < end && (*at == literal::minus || *at == literal::plus) )
+				++at;
+			if( ! digit() ) return fail();
+			int e = 0;
+			while( digit() ) e = e * 10 + (*at++ - literal::digit0);
+			exp += eneg ? -e : e;
+		}
+		long double scale = 1, base = 10;
+		for(int e = exp < 0 ? -exp : exp; e; e >>= 1, base *= base)
+			if( e & 1 ) scale *= base;
+		val = exp < 0 ? val / scale : val * scale;
+		dst = static_cast<T>(neg ? -val : val);
+		return true;
+	}
+	/** skips a value of any kind										*/
+	constexpr bool ignore() noexcept {
+		const char_t* b = nullptr;
+		const char_t* e = nullptr;
+		switch( peek() ) {
+		case literal::quotation_mark:
+			return string(nullptr, 0);
+		case literal::begin_object:
+			++at;
+			if( accept(literal::end_object) ) return true;
+			do if( ! (key(b, e) && ignore()) ) return false;
+			while( accept(literal::value_separator) );
+			return expect(literal::end_object);
+		case literal::begin_array:
+			++at;
+			if( accept(literal::end_array) ) return true;
+			do if( ! ignore() ) return false;
+			while( accept(literal::value_separator) );
+			return expect(literal::end_array);
+		case 't':
+			return word("true");
+		case 'f':
+			return word("false");
+		case 'n':
+			return null();
+		default:
+			long double val = 0;
+			return real(val);
+		}
+	}
+};
+
+template<class C, class ... L>
+struct fields;
+
+/** no field matched the name, the value is skipped							*/
+template<class C>
+struct fields<C> {
+	static constexpr bool read(cursor& in, C&,
+			const char_t*, const char_t*) noexcept {
+		return in.ignore();
+	}
+};
+
+template<class C, class H, class ... T>
+struct fields<C, H, T...> {
+	static constexpr bool read(cursor& in, C& obj,
+			const char_t* b, const char_t* e) noexcept {
+		return H::match(b, e) ? H::read(in, obj)
+			: fields<C, T...>::read(in, obj, b, e);
+	}
+};
+
+template<class V, typename T, size_t N>
+constexpr bool vector(cursor& in, T (&dst)[N]) noexcept {
+	if( ! in.expect(literal::begin_array) ) return false;
+	if( in.accept(literal::end_array) ) return true;
+	size_t i = 0;
+	do {
+		if( i >= N ) return in.fail();
+		if( ! (in.null() || V::read(in, dst[i])) ) return false;
+		++i;
+	} while( in.accept(literal::value_separator) );
+	return in.expect(literal::end_array);
 }
 
+/** value of an object structured with fields L								*/
+template<class ... L>
+struct value {
+	template<class C>
+	static constexpr bool read(cursor& in, C& obj) noexcept {
+		if( ! in.expect(literal::begin_object) ) return false;
+		if( in.accept(literal::end_object) ) return true;
+		do {
+			const char_t* b = nullptr;
+			const char_t* e = nullptr;
+			if( ! (in.key(b, e) && fields<C, L...>::read(in, obj, b, e)) )
+				return false;
+		} while( in.accept(literal::value_separator) );
+		return in.expect(literal::end_object);
+	}
+	template<class C, size_t N>
+	static constexpr bool read(cursor& in, C (&dst)[N]) noexcept {
+		return vector<value>(in, dst);
+	}
+};
+
+/** scalar, string or array of scalars										*/
+template<>
+struct value<> {
+	template<typename T>
+	static constexpr bool read(cursor& in, T& dst) noexcept {
+		return in.number(dst);
+	}
+	template<size_t N>
+	static constexpr bool read(cursor& in, char_t (&dst)[N]) noexcept {
+		return in.string(dst, N);
+	}
+	template<typename T, size_t N>
+	static constexpr bool read(cursor& in, T (&dst)[N]) noexcept {
+		return vector<value>(in, dst);
+	}
+};
+
+} /* namespace constant */
+#endif
+
+
+}
+using details::selector;
+
 /**
  * scalar class property
  */
 template<class C, details::name id, typename T, T C::*V>
 const details::property<C> & P() noexcept {
-	static const struct local : details::propertyx<accessor::field<C,T,V>> {
+	static constexpr struct local final : details::propertyx<accessor::field<C,T,V>> {
 		cstring name() const noexcept { return id(); }
-	} l;
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
+	} l {};
 	return l;
 }
 
@@ -1582,9 +2961,12 @@ const details::property<C> & P() noexcept {
  */
 template<class C, details::name id, class X>
 const details::property<C> & P() noexcept {
-	static const struct local : details::propertyx<X> {
+	static constexpr struct local final : details::propertyx<X> {
 		cstring name() const noexcept { return id(); }
-	} l;
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
+	} l {};
 	return l;
 }
 
@@ -1593,15 +2975,40 @@ const details::property<C> & P() noexcept {
  */
 template<class C, details::name id, size_t N, char_t (C::*M)[N]>
 const details::property<C> & P() noexcept {
-	static const struct local : details::property<C> {
+	static constexpr struct local final : details::property<C> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool read(C& obj, details::lexer& in) const noexcept {
 			return details::reader<char_t*>::read(obj.*M, N, in);
 		}
 		bool write(const C& obj, details::ostream& out) const noexcept {
 			return details::writer<const char_t*>::write(obj.*M, out);
 		}
-	} l;
+	} l {};
+	return l;
+}
+
+/**
+ * interned string class property, values are interned in pool F
+ */
+template<class C, details::name id, typename T, T C::*V, details::pool& F()>
+const details::property<C> & P() noexcept {
+	static_assert(std::is_same<T, details::symbol>::value,
+		"interned property must be of type symbol");
+	static constexpr struct local final : details::property<C> {
+		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
+		bool read(C& obj, details::lexer& in) const noexcept {
+			return F().read(obj.*V, in);
+		}
+		bool write(const C& obj, details::ostream& out) const noexcept {
+			return details::writer<T>::write(obj.*V, out);
+		}
+	} l {};
 	return l;
 }
 
@@ -1610,15 +3017,28 @@ const details::property<C> & P() noexcept {
  */
 template<class C, details::name id, typename T, size_t N, T (C::*M)[N]>
 const details::property<C>& P() {
-	static const struct local : details::property<C> {
+	static constexpr struct local final : details::property<C> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool read(C& obj, details::lexer& in) const noexcept {
-			return details::collection<>::read(*this, obj, in);
+			return in.numbers(obj.*M, N)
+				|| details::collection<>::read(*this, obj, in);
 		}
 		bool write(const C& obj, details::ostream& out) const noexcept {
+			if( details::batched<T>::value )
+				return details::array::numbers(obj.*M, N, out);
 			/* delegate write to array */
 			return details::array::write(*this, obj, out);
 		}
+		bool compile(details::composer& out, const C& obj) const noexcept {
+			bool r = out.put(details::literal::begin_array);
+			for(size_t i = 0; i < N && r; ++i)
+				r = (i == 0 || out.put(details::literal::value_separator))
+					&& out.value((obj.*M)[i]);
+			return r && out.put(details::literal::end_array);
+		}
 		/** read item */
 		inline bool read(C& obj, details::lexer& in, size_t i) const noexcept {
 			return
@@ -1631,7 +3051,7 @@ const details::property<C>& P() {
 			details::writer<T>::write((obj.*M)[i], out);
 			return i < N-1;
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1640,15 +3060,21 @@ const details::property<C>& P() {
  */
 template<class C,details::name id,class T,T C::*V,const details::clas<T>& S()>
 const details::property<C> & P() {
-	static const struct local : details::property<C> {
+	static constexpr struct local final : details::property<C> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool read(C& obj, details::lexer& in) const noexcept {
 			return S().read(obj.*V, in);
 		}
 		bool write(const C& obj, details::ostream& out) const noexcept {
 			return S().write(obj.*V, out);
 		}
-	} l;
+		bool compile(details::composer& out, const C& obj) const noexcept {
+			return S().compile(out, obj.*V);
+		}
+	} l {};
 	return l;
 }
 
@@ -1658,14 +3084,24 @@ const details::property<C> & P() {
 template<class C, details::name id, class T,
 	size_t N, T (C::*V)[N], const details::clas<T>& S()>
 const details::property<C> & P() {
-	static const struct local : details::property<C> {
+	static constexpr struct local final : details::property<C> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool read(C& obj, details::lexer& in) const noexcept {
 			return details::collection<>::read(*this, obj, in);
 		}
 		bool write(const C& obj, details::ostream& out) const noexcept {
 			return details::array::write(*this, obj, out);
 		}
+		bool compile(details::composer& out, const C& obj) const noexcept {
+			bool r = out.put(details::literal::begin_array);
+			for(size_t i = 0; i < N && r; ++i)
+				r = (i == 0 || out.put(details::literal::value_separator))
+					&& S().compile(out, (obj.*V)[i]);
+			return r && out.put(details::literal::end_array);
+		}
 		/** read item */
 		inline bool read(C& obj, details::lexer& in, size_t i) const noexcept {
 			S().read((obj.*V)[i], in);
@@ -1677,7 +3113,7 @@ const details::property<C> & P() {
 			S().write((obj.*V)[i], out);
 			return i < N-1;
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1688,10 +3124,137 @@ template<class C, typename details::property<C>::node ... L>
 const details::clas<C>& O() noexcept {
 	static constexpr typename details::property<C>::node list[] { L ... } ;
 	static constexpr auto size = sizeof...(L);
-	static const details::clas<C> l(list,size);
+	static constexpr details::clas<C> l(list, size);
 	return l;
 }
 
+/**
+ * descriptor of a member of type T at offset in a class, for use
+ * in constant tables of a table-driven schema, e.g.
+ * static constexpr details::descriptor table[] = {
+ * 		D<decltype(C::x)>(Name::x, offsetof(C, x)), ...
+ * };
+ * Names are kept in the table as text, so the name functions must be
+ * constexpr, unless names are in progmem
+ */
+template<typename T>
+constexpr details::descriptor D(details::name id, size_t offset) noexcept {
+	static_assert( ! std::is_class<
+		typename std::remove_all_extents<T>::type>::value,
+		"Nested objects require a table, use D<T>(id, offset, table)");
+	return details::describe<T>::make(id, offset, nullptr, 0);
+}
+
+/**
+ * descriptor of a nested object or an array of objects of type T,
+ * structured with table S
+ */
+template<typename T, size_t N>
+constexpr details::descriptor D(details::name id, size_t offset,
+		const details::descriptor (&S)[N]) noexcept {
+	static_assert(std::is_class<
+		typename std::remove_all_extents<T>::type>::value,
+		"Only nested objects are structured with a table");
+	return details::describe<T>::make(id, offset, S, N);
+}
+
+/**
+ * descriptors with constant name id, written with prebuilt prefixes
+ * as P<> members are, e.g. D<decltype(C::x), Name::x>(offsetof(C, x))
+ */
+template<typename T, details::name id>
+constexpr details::descriptor D(size_t offset) noexcept {
+	static_assert( ! std::is_class<
+		typename std::remove_all_extents<T>::type>::value,
+		"Nested objects require a table, use D<T, id>(offset, table)");
+	return details::describe<T>::make(id, offset, nullptr, 0,
+		details::caption<>::prefix<id>());
+}
+
+template<typename T, details::name id, size_t N>
+constexpr details::descriptor D(size_t offset,
+		const details::descriptor (&S)[N]) noexcept {
+	static_assert(std::is_class<
+		typename std::remove_all_extents<T>::type>::value,
+		"Only nested objects are structured with a table");
+	return details::describe<T>::make(id, offset, S, N,
+		details::caption<>::prefix<id>());
+}
+
+#if __cpp_constexpr >= 201304
+/**
+ * JSON object associated with a C++ class, structured with K<> fields
+ */
+template<class C, class ... L>
+const details::clas<C>& O() noexcept {
+	return O<C, L::property...>();
+}
+
+/**
+ * field of class C, member V of type T, named id - a type-level property,
+ * usable both in O<C, K...>() for run-time i/o and in preset<C, K...>(json)
+ * for compile-time parsing. T may be a scalar, char_t[N], an array of
+ * scalars, or, with fields G..., a nested object or an array of objects
+ */
+template<class C, details::name id, typename T, T C::*V, class ... G>
+struct K {
+	typedef std::integral_constant<bool, (sizeof...(G) > 0)> nested;
+	static const details::property<C>& property() noexcept {
+		return bind(static_cast<T*>(nullptr), nested());
+	}
+	static constexpr bool match(const char_t* b, const char_t* e) noexcept {
+		cstring n = id();
+		while( b < e && *n && *n == *b ) ++n, ++b;
+		return b == e && *n == 0;
+	}
+	static constexpr bool read(details::constant::cursor& in,
+			C& obj) noexcept {
+		return in.null() || details::constant::value<G...>::read(in, obj.*V);
+	}
+private:
+	template<typename U>
+	static const details::property<C>& bind(U*, std::false_type) noexcept {
+		return P<C, id, U, V>();
+	}
+	template<size_t N>
+	static const details::property<C>& bind(char_t (*)[N],
+			std::false_type) noexcept {
+		return P<C, id, N, V>();
+	}
+	template<typename U, size_t N>
+	static const details::property<C>& bind(U (*)[N],
+			std::false_type) noexcept {
+		return P<C, id, U, N, V>();
+	}
+	template<typename U>
+	static const details::property<C>& bind(U*, std::true_type) noexcept {
+		return P<C, id, U, V, O<U, G...>>();
+	}
+	template<typename U, size_t N>
+	static const details::property<C>& bind(U (*)[N],
+			std::true_type) noexcept {
+		return P<C, id, U, N, V, O<U, G...>>();
+	}
+};
+
+/**
+ * instance of C, parsed at compile time from a JSON literal with K<> fields
+ * L, e.g.
+ * static constexpr Config defaults = preset<Config, K<...>, ...>("{...}");
+ * C must be a literal type. Members missing in the literal or given as null
+ * keep their default values. Evaluated at run time, parsing stops at the
+ * first error.
+ */
+template<class C, class ... L, size_t N>
+constexpr C preset(const char_t (&json)[N]) noexcept {
+	C obj {};
+	details::constant::cursor in(json, json + N - 1);
+	if( details::constant::value<L...>::read(in, obj) && in.peek() )
+		in.fail();
+	return obj;
+}
+#endif
+
 /**
  * JSON object
  */
@@ -1699,7 +3262,7 @@ template<details::node ... L>
 const details::value& V() noexcept {
 	static constexpr details::node list[] { L ... };
 	static constexpr unsigned size = sizeof...(L);
-	static const details::object l(list, size);
+	static constexpr details::object l(list, size);
 	return l;
 }
 
@@ -1711,7 +3274,7 @@ template<details::item ... L>
 const details::value& V() noexcept {
 	static constexpr details::item items[] { L ... };
 	static constexpr auto size = sizeof...(L);
-	static details::array l(items, size);
+	static constexpr details::array l(items, size);
 	return l;
 }
 
@@ -1720,7 +3283,7 @@ const details::value& V() noexcept {
  */
 template<size_t N, char_t (&A)[N]>
 const details::value& V() noexcept {
-	static const details::string l(A,N);
+	static constexpr details::string l(A,N);
 	return l;
 }
 
@@ -1730,7 +3293,7 @@ const details::value& V() noexcept {
  */
 template<size_t N, char_t* (*F)() noexcept>
 const details::value& V() noexcept {
-	static const details::string l(F(),N);
+	static constexpr details::stringf<char_t, F, N> l {};
 	return l;
 }
 
@@ -1739,7 +3302,7 @@ const details::value& V() noexcept {
  */
 template<const char_t* (*F)() noexcept>
 const details::value& V() noexcept {
-	static const details::string l(F());
+	static constexpr details::stringf<const char_t, F> l {};
 	return l;
 }
 
@@ -1749,7 +3312,7 @@ const details::value& V() noexcept {
  */
 template<class X>
 const details::value& V() noexcept {
-	static const details::values<X> l;
+	static constexpr details::values<X> l {};
 	return l;
 }
 
@@ -1760,7 +3323,7 @@ const details::value& V() noexcept {
  */
 template<class X, const details::clas<typename X::clas>& (*S)() noexcept>
 const details::value& V() noexcept {
-	static const details::objects<X,S> l;
+	static constexpr details::objects<X,S> l {};
 	return l;
 }
 
@@ -1769,7 +3332,7 @@ const details::value& V() noexcept {
  */
 template<typename T, T* P>
 const details::value& V() noexcept {
-	static const details::scalar<accessor::pointer<T,P>> l;
+	static constexpr details::scalar<accessor::pointer<T,P>> l {};
 	return l;
 }
 
@@ -1779,7 +3342,7 @@ const details::value& V() noexcept {
  */
 template<typename T, T& (*F)() noexcept>
 const details::value& V() noexcept {
-	static const details::scalar<accessor::reference<T,F>> l;
+	static constexpr details::scalar<accessor::reference<T,F>> l {};
 	return l;
 }
 
@@ -1788,7 +3351,7 @@ const details::value& V() noexcept {
  */
 template<typename T, T* (*F)() noexcept>
 const details::value& V() noexcept {
-	static const details::scalar<accessor::function<T,F>> l;
+	static constexpr details::scalar<accessor::function<T,F>> l {};
 	return l;
 }
 
@@ -1797,7 +3360,7 @@ const details::value& V() noexcept {
  */
 template<typename T, T (*G)() noexcept, void (*S)(T) noexcept>
 const details::value& V() noexcept {
-	static const details::scalar<accessor::functions<T,G,S>> l;
+	static constexpr details::scalar<accessor::functions<T,G,S>> l {};
 	return l;
 }
 
@@ -1807,7 +3370,7 @@ const details::value& V() noexcept {
  */
 template<typename T, size_t N, T (&A)[N]>
 const details::value& V() noexcept {
-	static const details::vector<accessor::array<T,N,A>> l;
+	static constexpr details::vector<accessor::array<T,N,A>> l {};
 	return l;
 }
 
@@ -1816,7 +3379,7 @@ const details::value& V() noexcept {
  */
 template<typename T, T* (*F)(size_t) noexcept>
 const details::value& V() noexcept {
-	static const details::vector<accessor::vector<T,F>> l;
+	static constexpr details::vector<accessor::vector<T,F>> l {};
 	return l;
 }
 
@@ -1825,15 +3388,18 @@ const details::value& V() noexcept {
  */
 template<details::name id, details::item I>
 const details::member& M() noexcept {
-	static const struct local : details::member {
+	static constexpr struct local final : details::member {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
 			return I().read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
 			return I().write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1842,12 +3408,19 @@ const details::member& M() noexcept {
  */
 template<details::name id, size_t N, char_t* (*F)() noexcept>
 const details::member& M() noexcept {
-	static const struct local : details::member, details::string {
-		inline local() noexcept : details::string(F(),N) {}
+	static constexpr struct local final : details::member,
+		details::stringf<char_t, F, N> {
 		cstring name() const noexcept { return id(); }
-		bool readval(details::lexer& in) const noexcept { return read(in); }
-		bool writeval(details::ostream& out) const noexcept { return write(out); }
-	} l;
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
+		bool readval(details::lexer& in) const noexcept {
+			return details::stringf<char_t, F, N>::read(in);
+		}
+		bool writeval(details::ostream& out) const noexcept {
+			return details::stringf<char_t, F, N>::write(out);
+		}
+	} l {};
 	return l;
 }
 
@@ -1856,16 +3429,19 @@ const details::member& M() noexcept {
  */
 template<details::name id, const char_t* (*F)() noexcept>
 const details::member& M() noexcept {
-	static const struct local : details::member, details::string {
-		inline local() noexcept : details::string(F()) {}
+	static constexpr struct local final : details::member,
+		details::stringf<const char_t, F> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
-			return read(in);
+			return details::stringf<const char_t, F>::read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
-			return write(out);
+			return details::stringf<const char_t, F>::write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1875,15 +3451,18 @@ const details::member& M() noexcept {
  */
 template<details::name id, class X>
 const details::member& M() noexcept {
-	static const struct local : details::member, details::values<X> {
+	static constexpr struct local final : details::member, details::values<X> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
 			return details::values<X>::read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
 			return details::values<X>::write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1892,15 +3471,18 @@ const details::member& M() noexcept {
  */
 template<details::name id, typename T, T& (*F)() noexcept>
 const details::member& M() noexcept {
-	static const struct local : details::member, details::values<accessor::reference<T,F>> {
+	static constexpr struct local final : details::member, details::values<accessor::reference<T,F>> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
 			return details::values<accessor::reference<T,F>>::read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
 			return details::values<accessor::reference<T,F>>::write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1909,16 +3491,19 @@ const details::member& M() noexcept {
  */
 template<details::name id, typename T, T* P>
 const details::member& M() noexcept {
-	static const struct local : details::member,
+	static constexpr struct local final : details::member,
 		details::scalar<accessor::pointer<T,P>> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
 			return details::scalar<accessor::pointer<T,P>>::read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
 			return details::scalar<accessor::pointer<T,P>>::write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1928,16 +3513,19 @@ const details::member& M() noexcept {
  */
 template<details::name id, typename T, T* (*F)() noexcept>
 const details::member& M() noexcept {
-	static const struct local : details::member,
+	static constexpr struct local final : details::member,
 		details::scalar<accessor::function<T,F>> {
 		cstring name() const noexcept { return id(); }
+		details::fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
 		bool readval(details::lexer& in) const noexcept {
 			return details::scalar<accessor::function<T,F>>::read(in);
 		}
 		bool writeval(details::ostream& out) const noexcept {
 			return details::scalar<accessor::function<T,F>>::write(out);
 		}
-	} l;
+	} l {};
 	return l;
 }
 
@@ -1988,6 +3576,13 @@ public:
 		ptr[pos++] = val;
 		return true;
 	}
+	bool write(const char_t* s, size_t n) noexcept {
+		bool fits = pos <= size() && n <= size() - pos;
+		if( ! fits ) n = pos < size() ? size() - pos : 0;
+		while( n-- ) ptr[pos++] = *s++;
+		if( ! fits ) error(error_t::eof);
+		return fits;
+	}
 	inline void restart() noexcept {
 		clear();
 		pos = 0;
@@ -2003,6 +3598,369 @@ private:
 	char_t *ptr;
 };
 
+/**
+ * An input stream over a constant array of char_t, exposed to the lexer
+ * as an inline window, so that reading does not involve virtual calls
+ */
+class source : public istream {
+public:
+	source() noexcept : ptr(nullptr) { }
+	/** zero-terminated string												*/
+	source(const char_t* data) noexcept : ptr(data) { restart(length()); }
+	source(const char_t* data, size_t n) noexcept : ptr(data) { restart(n); }
+	bool get(char_t& val) noexcept {
+		val = iostate::eos_c;
+		error(error_t::eof);
+		return false;
+	}
+	inline size_t count() const noexcept {
+		return gnext - ptr;
+	}
+	inline void restart() noexcept {
+		restart(gend - ptr);
+	}
+	void set(const char_t* data) noexcept {
+		ptr = data;
+		restart(length());
+	}
+	void set(const char_t* data, size_t n) noexcept {
+		ptr = data;
+		restart(n);
+	}
+private:
+	inline void restart(size_t n) noexcept {
+		clear();
+		window(ptr, ptr + n);
+	}
+	inline size_t length() const noexcept {
+		size_t n = 0;
+		if( ptr ) while( ptr[n] ) ++n;
+		return n;
+	}
+	const char_t* ptr;
+};
+
+/**
+ * An output stream over an array of char_t, exposed to writers as a put
+ * area, so that writing does not involve virtual calls. Writing past the
+ * end of the array fails with error_t::eof
+ */
+class target : public ostream {
+public:
+	target() noexcept : ptr(nullptr) { }
+	template<size_t N>
+	target(char_t (&data)[N]) noexcept : ptr(data) { restart(N); }
+	target(char_t* data, size_t n) noexcept : ptr(data) { restart(n); }
+	bool put(char_t c) noexcept {
+		if( pnext != pend ) {
+			*pnext++ = c;
+			return true;
+		}
+		error(error_t::eof);
+		return false;
+	}
+	inline size_t count() const noexcept {
+		return pnext - ptr;
+	}
+	inline void restart() noexcept {
+		restart(pend - ptr);
+	}
+	void set(char_t* data, size_t n) noexcept {
+		ptr = data;
+		restart(n);
+	}
+private:
+	inline void restart(size_t n) noexcept {
+		clear();
+		area(ptr, ptr + n);
+	}
+	char_t* ptr;
+};
+
+/**
+ * An input stream over a mutable array of char_t. Strings read from it
+ * as views are decoded in place, shrinking within the array
+ */
+class inplace : public source {
+public:
+	inplace() noexcept { writable(true); }
+	/** zero-terminated string												*/
+	inplace(char_t* data) noexcept : source(data) { writable(true); }
+	inplace(char_t* data, size_t n) noexcept : source(data, n) {
+		writable(true);
+	}
+	void set(char_t* data) noexcept {
+		source::set(data);
+	}
+	void set(char_t* data, size_t n) noexcept {
+		source::set(data, n);
+	}
+};
+
+/**
+ * tokens - schema-less pull reader over a lexer. next returns kind of
+ * the next token. Text of a key, a string or a number is given by text,
+ * as a view into the inline window if the token is there and has no
+ * escapes. Otherwise text is null and the token is read in chunks with
+ * read, the unread part is skipped by next. Numbers are collected in own
+ * buffer. No allocations, nesting is limited to 32 levels
+ */
+class tokens : noncopyable {
+public:
+	enum class kind : unsigned char {
+		begin_object, end_object, begin_array, end_array,
+		key, string, number, boolean, null, end, error
+	};
+	explicit inline tokens(lexer& lex) noexcept
+	  : in(lex), nest(0), level(0), expect(state::start), open(false),
+		flag(false) {}
+	/** reads next token												*/
+	kind next() noexcept;
+	/** text of the current key, string or number, null if not a view	*/
+	inline const view& text() const noexcept { return txt; }
+	/** reads up to n characters of the current key or string not given
+	 * as a view, returns number of characters read, 0 at its end		*/
+	size_t read(char_t* dst, size_t n) noexcept;
+	/** value of the current boolean token								*/
+	inline bool boolean() const noexcept { return flag; }
+	/** converts the current number token to T							*/
+	template<typename T>
+	bool as(T& dst) const noexcept {
+		source src(txt.data(), txt.size());
+		lexer lex(src);
+		return reader<T>::read(dst, lex);
+	}
+	/** skips the rest of the object or array at the current level		*/
+	bool skip() noexcept;
+	/** nesting level of the current token								*/
+	inline size_t depth() const noexcept { return level; }
+private:
+	enum class state : unsigned char {
+		start, value, item, member, key, colon, after, done, failed
+	};
+	kind value(char_t chr) noexcept;
+	kind string(kind k, state then) noexcept;
+	kind close(kind k) noexcept;
+	inline state following() const noexcept {
+		return level ? state::after : state::done;
+	}
+	inline kind fail() noexcept {
+		expect = state::failed;
+		return kind::error;
+	}
+	inline bool object() const noexcept { return nest & 1; }
+	lexer& in;
+	view txt;
+	uint32_t nest;				/* one bit per level, set for objects		*/
+	unsigned char level;
+	state expect;
+	bool open;
+	bool flag;
+	char_t num[32];
+};
+
+/**
+ * tape - flat representation of a document of any shape, parsed in one
+ * pass into an array of cells supplied by the caller. A cell holds kind
+ * of the token, its offset in the input and, for keys, strings and
+ * numbers, length of its text. Numbers are parsed, integers fitting long
+ * are kept as such, others as double. A container holds count of its
+ * members or items and index of the cell past its end, so that it can be
+ * skipped at once. Strings are kept as in the input, with escapes, thus
+ * the input must outlive the tape. Object members are pairs of a key
+ * cell followed by the value cells.
+ */
+class tape : noncopyable {
+public:
+	enum class kind : unsigned char {
+		object, array, key, string, integer, real, boolean, null
+	};
+	struct cell {
+		kind type;
+		size_t at;			/* offset of the token in the input			*/
+		size_t size;		/* length of text or count of members/items	*/
+		union {
+			size_t end;		/* index of the cell past the container		*/
+			long integer;
+			double real;
+			bool boolean;
+		};
+	};
+	static constexpr size_t none = static_cast<size_t>(-1);
+	inline tape(cell* cells, size_t n) noexcept
+	  : data(cells), capacity(n), count(0), input(nullptr), err(error_t::noerror) {}
+	template<size_t N>
+	inline tape(cell (&cells)[N]) noexcept : tape(cells, N) {}
+	/** parses n characters of json, returns true on success			*/
+	bool parse(const char_t* json, size_t n) noexcept;
+	/** parses a zero-terminated json									*/
+	bool parse(const char_t* json) noexcept;
+	/** number of cells used											*/
+	inline size_t size() const noexcept { return count; }
+	inline const cell& operator[](size_t i) const noexcept { return data[i]; }
+	inline const cell* begin() const noexcept { return data; }
+	inline const cell* end() const noexcept { return data + count; }
+	/** index of the cell past cell i and its content					*/
+	inline size_t next(size_t i) const noexcept {
+		return data[i].type == kind::object || data[i].type == kind::array ?
+			data[i].end : i + 1;
+	}
+	/** index of n-th item of array i or of n-th value of object i		*/
+	size_t item(size_t i, size_t n) const noexcept;
+	/** index of value of member name in object i, keys are compared
+	 * decoded, with escapes resolved									*/
+	size_t find(size_t i, const char_t* name) const noexcept;
+	/** text of key, string or number i as in the input					*/
+	inline view text(size_t i) const noexcept {
+		return view(input + data[i].at, data[i].size);
+	}
+	/** decodes key or string i into dst of n characters, zero-terminated,
+	 * returns false if it does not fit									*/
+	bool read(size_t i, char_t* dst, size_t n) const noexcept;
+	/** writes value i as JSON											*/
+	bool write(ostream& out, size_t i = 0) const noexcept;
+	/** error of the last parse											*/
+	inline error_t error() const noexcept { return err; }
+private:
+	bool add(kind type, size_t at, size_t size) noexcept;
+	bool matches(size_t i, const char_t* name) const noexcept;
+	bool number(size_t& pos, size_t n) noexcept;
+	bool scalar(size_t& pos, size_t n) noexcept;
+	bool string(kind type, size_t& pos, size_t n) noexcept;
+	inline bool fail(error_t e) noexcept {
+		err |= e;
+		return false;
+	}
+	cell* const data;
+	const size_t capacity;
+	size_t count;
+	const char_t* input;
+	error_t err;
+};
+
+/**
+ * lines - input stream presenting one line of the underlying stream at a
+ * time, the newline reads as the end of stream. advance moves to the next
+ * line, skipping the rest of the current one. Lines are passed through the
+ * inline window when the underlying stream has one
+ */
+class lines : public istream {
+public:
+	static constexpr char_t newline = '\n';
+	explicit inline lines(istream& input) noexcept
+	  : in(input), chars(0), started(false), ended(false), over(false) {}
+	bool get(char_t& dst) noexcept;
+	/** moves to the next line, returns false at the end of input		*/
+	bool advance() noexcept;
+	/** number of characters taken from the underlying stream			*/
+	inline unsigned long characters() const noexcept { return chars; }
+private:
+	bool end(char_t& dst) noexcept;
+	istream& in;
+	unsigned long chars;
+	bool started;
+	bool ended;
+	bool over;
+};
+
+/**
+ * records - reader of newline delimited JSON (JSON Lines), records of the
+ * same structure read one by one with a single lexer. BOM is skipped once,
+ * blank lines are ignored, a malformed record is counted and skipped up to
+ * the next newline
+ */
+template<class C>
+class records : noncopyable {
+public:
+	inline records(istream& in, const clas<C>& S) noexcept
+	  : input(in), lex(input), structure(S), good(0), bad(0) {}
+	/** records reading member names into the caller supplied scratch	*/
+	template<size_t N>
+	inline records(istream& in, const clas<C>& S,
+			char_t (&scratch)[N]) noexcept
+	  : input(in), lex(input, scratch), structure(S), good(0), bad(0) {}
+	/** reads the next well-formed record into obj, returns false at the
+	 * end of input														*/
+	bool read(C& obj) noexcept {
+		char_t chr;
+		while( input.advance() ) {
+			const bool first = input.characters() == 0;
+			lex.restart();
+			if( first ) lex.skip_bom();
+			if( ! lex.skipws(chr) && chr == iostate::eos_c ) continue;
+			lex.back(chr);
+			if( structure.read(obj, lex) ) {
+				lex.skipws(chr);
+				if( chr == iostate::eos_c ) {
+					++good;
+					return true;
+				}
+			}
+			++bad;
+		}
+		return false;
+	}
+	/** number of records read											*/
+	inline unsigned long count() const noexcept { return good; }
+	/** number of malformed records skipped								*/
+	inline unsigned long failures() const noexcept { return bad; }
+	/** number of characters consumed									*/
+	inline unsigned long characters() const noexcept {
+		return input.characters();
+	}
+	/** lexer of the records, e.g. to give it an arena					*/
+	inline lexer& scanner() noexcept { return lex; }
+private:
+	lines input;
+	lexer lex;
+	const clas<C>& structure;
+	unsigned long good;
+	unsigned long bad;
+};
+
+/**
+ * journal - writer of newline delimited JSON, each record is terminated
+ * with a newline, even if writing it failed, to keep the framing
+ */
+template<class C>
+class journal : public ostream {
+public:
+	inline journal(ostream& output, const clas<C>& S) noexcept
+	  : out(output), structure(S), good(0), bad(0), chars(0) {}
+	/** writes obj as a record, returns true on success					*/
+	bool write(const C& obj) noexcept {
+		const bool r = structure.write(obj, *this);
+		if( put(lines::newline) && r ) {
+			++good;
+			return true;
+		}
+		++bad;
+		return false;
+	}
+	bool put(char_t c) noexcept {
+		if( ! out.put(c) ) return false;
+		++chars;
+		return true;
+	}
+	bool write(const char_t* s, size_t n) noexcept {
+		if( ! out.write(s, n) ) return false;
+		chars += n;
+		return true;
+	}
+	/** number of records written										*/
+	inline unsigned long count() const noexcept { return good; }
+	/** number of records failed to write								*/
+	inline unsigned long failures() const noexcept { return bad; }
+	/** number of characters written									*/
+	inline unsigned long characters() const noexcept { return chars; }
+private:
+	ostream& out;
+	const clas<C>& structure;
+	unsigned long good;
+	unsigned long bad;
+	unsigned long chars;
+};
+
 /**
  * An obuffer wrapper to an external array of char_type
  * given by pointer and size
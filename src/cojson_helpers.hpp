@@ -89,8 +89,45 @@ static auto test_strcmp(long) -> std::false_type;
 
 template<typename T>
 struct has_strcmp : decltype(test_strcmp<T>(0)){};
+
+/* constant expression, e.g. a name function declared constexpr */
+template<int>
+struct constant_true : std::true_type{};
+
+template<typename F, F f>
+static auto test_constexpr(int) -> constant_true<(f()[0], 0)>;
+
+template<typename F, F>
+static auto test_constexpr(long) -> std::false_type;
+
+template<typename F, F f>
+struct is_constexpr : decltype(test_constexpr<F,f>(0)){};
+
+/* extent of contiguous items of an accessor, 0 if X does not declare it */
+template<class X>
+static auto test_extent(int)
+	-> std::integral_constant<unsigned long, X::extent>;
+
+template<class>
+static auto test_extent(long) -> std::integral_constant<unsigned long, 0>;
+
+template<class X>
+struct extent_of : decltype(test_extent<X>(0)){};
 }
 namespace details {
+/******************************************************************************/
+/* compile time index sequence, a C++11 substitute for std::index_sequence	  */
+template<unsigned ... I>
+struct indices {};
+
+template<unsigned N, unsigned ... I>
+struct make_indices : make_indices<N-1, N-1, I...> {};
+
+template<unsigned ... I>
+struct make_indices<0, I...> {
+	typedef indices<I...> type;
+};
+
 /******************************************************************************/
 /* writer's helpers															  */
 
@@ -208,7 +208,8 @@ inline bool write_double_impl<config::write_double_impl_is::internal>(
 template<>
 inline bool write_double_impl<config::write_double_impl_is::with_sprintf>(
 		const double& val, ostream& out) noexcept {
-	temporary tmp;
+	/* automatic, to keep concurrent writers independent */
+	temporary_s<config::temporary_size, config::temporary_is::_automatic> tmp;
 	if( ! any<char_t>::gfmt(tmp.buffer, tmp.size, val) ) {
 		out.error(error_t::overrun);
 		return false;
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_parallel.hpp - multi-threaded reading and writing on hosts
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#ifndef COJSON_PARALLEL_HPP_
+#define COJSON_PARALLEL_HPP_
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifndef COJSON_HPP_
+#	include "cojson.hpp"
+#endif
+
+/*
+ * Motivation
+ *
+ * Reading of a large document held in memory is bound to a single core,
+ * as the lexer is sequential. Documents made of independent parts, such as
+ * newline delimited logs, can be split at part boundaries and the parts
+ * read in parallel, each worker thread with own lexer and scratch.
+ * Work is handed out in chunks of fixed size, taken by idle workers from
+ * a shared atomic counter, so that uneven parts are balanced without a
+ * central queue. Chunk boundaries are found by each worker on its own:
+ * a chunk holds the lines starting within it.
+ * A single top level array is read likewise, once its elements are found
+ * with a fast structural pass, that tracks nesting and strings only.
+ * Elements are read in batches into their own places, so the result is in
+ * the original order regardless of the scheduling.
+ * A large array of objects is written in slices, serialized by workers
+ * into own buffers and passed to the output in order.
+ * This file requires threads and is meant for hosts only, offsets and
+ * counts are std::size_t, as documents may exceed the 32-bit range.
+ *
+ * Example:
+ *
+ *   std::vector<std::vector<Entry>> found(parallel::workers());
+ *   auto totals = parallel::records(map.data(), map.size(),
+ *       Entry::structure(), [&](unsigned worker, size_t, const Entry& e) {
+ *           found[worker].push_back(e);
+ *       });
+ */
+
+namespace cojson {
+namespace details {
+namespace parallel {
+
+/** counters summed over workers											*/
+struct totals {
+	unsigned long records;
+	unsigned long failures;
+	unsigned long characters;
+};
+
+/** default number of workers												*/
+static inline unsigned workers() noexcept {
+	const unsigned n = std::thread::hardware_concurrency();
+	return n ? n : 1;
+}
+
+/** runs job(worker) in n threads, the calling thread is the worker 0		*/
+template<typename F>
+void run(unsigned n, F&& job) {
+	std::vector<std::thread> threads;
+	threads.reserve(n ? n - 1 : 0);
+	for(unsigned i = 1; i < n; ++i)
+		threads.emplace_back([&job, i]() { job(i); });
+	job(0);
+	for(std::thread& t : threads) t.join();
+}
+
+/** position past the first newline at or after pos, or size				*/
+static inline std::size_t boundary(const char_t* data, std::size_t size,
+		std::size_t pos) noexcept {
+	if( pos == 0 || pos >= size ) return pos < size ? pos : size;
+	/* a line starting exactly at pos belongs to this chunk			*/
+	if( data[pos - 1] == lines::newline ) return pos;
+	while( pos < size && data[pos] != lines::newline ) ++pos;
+	return pos < size ? pos + 1 : size;
+}
+
+/**
+ * reads newline delimited records of structure S from size characters of
+ * data, in chunks of about chunk characters, with n workers. Each record
+ * read is passed to consume(worker, chunk, record), where chunk is index
+ * of the chunk in data, that allows restoring order of records.
+ * consume is called concurrently from different workers
+ */
+template<class C, typename F>
+totals records(const char_t* data, std::size_t size, const clas<C>& S,
+		F&& consume, unsigned n = workers(), std::size_t chunk = 65536) {
+	std::atomic<std::size_t> next(0);
+	std::atomic<unsigned long> good(0), bad(0), chars(0);
+	if( chunk == 0 ) chunk = 1;
+	const std::size_t count = size / chunk + (size % chunk ? 1 : 0);
+	run(n, [&](unsigned worker) {
+		char_t scratch[config::temporary_size];
+		C obj{};
+		for(std::size_t k; (k = next.fetch_add(1)) < count; ) {
+			const std::size_t begin = boundary(data, size, k * chunk);
+			const std::size_t end = boundary(data, size,
+				k + 1 < count ? (k + 1) * chunk : size);
+			if( begin >= end ) continue;
+			source in(data + begin, end - begin);
+			details::records<C> input(in, S, scratch);
+			/* a record may omit members, none carried over from the last	*/
+			for(;;) {
+				obj = C{};
+				if( ! input.read(obj) ) break;
+				consume(worker, k, obj);
+			}
+			good += input.count();
+			bad += input.failures();
+			chars += input.characters();
+		}
+	});
+	return totals { good, bad, chars };
+}
+
+/**
+ * finds bounds of elements of the top level array in size characters of
+ * data, placing begin and end offset of each element in marks.
+ * Returns false if data is not an array or an element is empty
+ */
+static inline bool split(const char_t* data, std::size_t size,
+		std::vector<std::size_t>& marks) {
+	std::size_t pos = 0;
+	std::size_t begin = 0;
+	std::size_t depth = 0;
+	bool quoted = false;
+	bool escaped = false;
+	bool empty = true;
+	marks.clear();
+	while( pos < size && isws(data[pos]) ) ++pos;
+	if( pos == size || data[pos] != literal::begin_array ) return false;
+	for(begin = ++pos; pos < size; ++pos) {
+		const char_t chr = data[pos];
+		if( quoted ) {
+			if( escaped ) escaped = false;
+			else if( chr == literal::escape ) escaped = true;
+			else if( chr == literal::quotation_mark ) quoted = false;
+			continue;
+		}
+		if( isws(chr) ) {
+			if( empty ) begin = pos + 1;
+			continue;
+		}
+		switch( chr ) {
+		case literal::quotation_mark:
+			quoted = true;
+			break;
+		case literal::begin_object:
+		case literal::begin_array:
+			++depth;
+			break;
+		case literal::end_object:
+			if( depth-- == 0 ) return false;
+			break;
+		case literal::end_array:
+			if( depth-- ) break;
+			if( empty && ! marks.empty() ) return false;
+			if( ! empty ) {
+				marks.push_back(begin);
+				marks.push_back(pos);
+			}
+			while( ++pos < size && isws(data[pos]) );
+			return pos == size;
+		case literal::value_separator:
+			if( depth ) break;
+			if( empty ) return false;
+			marks.push_back(begin);
+			marks.push_back(pos);
+			begin = pos + 1;
+			empty = true;
+			continue;
+		default:;
+		}
+		empty = false;
+	}
+	return false;
+}
+
+/** reads elements with bounds in marks into out, in n workers			*/
+template<class C>
+totals elements(const char_t* data, const std::vector<std::size_t>& marks,
+		const clas<C>& S, C* out, std::size_t count, unsigned n,
+		std::size_t batch) {
+	std::atomic<std::size_t> next(0);
+	std::atomic<unsigned long> good(0), bad(0), chars(0);
+	if( batch == 0 ) batch = 1;
+	run(n, [&](unsigned) {
+		char_t scratch[config::temporary_size];
+		char_t chr;
+		for(std::size_t k; (k = next.fetch_add(batch)) < count; ) {
+			const std::size_t last = k + batch < count ? k + batch : count;
+			unsigned long ok = 0, length = 0;
+			for(std::size_t i = k; i < last; ++i) {
+				const std::size_t begin = marks[2 * i];
+				const std::size_t end = marks[2 * i + 1];
+				source in(data + begin, end - begin);
+				lexer lex(in, scratch);
+				length += end - begin;
+				if( S.read(out[i], lex) ) {
+					lex.skipws(chr);
+					if( chr == iostate::eos_c ) {
+						++ok;
+						continue;
+					}
+				}
+				/* partly read or followed by junk						*/
+				out[i] = C{};
+			}
+			good += ok;
+			bad += (last - k) - ok;
+			chars += length;
+		}
+	});
+	return totals { good, bad, chars };
+}
+
+/**
+ * reads top level array of objects with structure S from size characters
+ * of data into out, in order, with n workers taking elements in batches.
+ * Elements are found with a structural pass first, out is resized to fit
+ * them. Elements that fail are counted and left default constructed.
+ * If data is not an array, out is cleared and failures set to 1
+ */
+template<class C>
+totals items(const char_t* data, std::size_t size, const clas<C>& S,
+		std::vector<C>& out, unsigned n = workers(), std::size_t batch = 64) {
+	std::vector<std::size_t> marks;
+	out.clear();
+	if( ! split(data, size, marks) ) return totals { 0, 1, 0 };
+	out.resize(marks.size() / 2);
+	return elements(data, marks, S, out.data(), out.size(), n, batch);
+}
+
+/**
+ * reads top level array of objects with structure S into array out of
+ * capacity elements. count receives number of elements in data, those
+ * not fitting out are counted as failures. Elements that fail are counted
+ * and reset to default constructed
+ */
+template<class C>
+totals items(const char_t* data, std::size_t size, const clas<C>& S,
+		C* out, std::size_t capacity, std::size_t& count,
+		unsigned n = workers(), std::size_t batch = 64) {
+	std::vector<std::size_t> marks;
+	count = 0;
+	if( ! split(data, size, marks) ) return totals { 0, 1, 0 };
+	count = marks.size() / 2;
+	totals t = elements(data, marks, S, out,
+		count < capacity ? count : capacity, n, batch);
+	if( count > capacity ) t.failures += count - capacity;
+	return t;
+}
+
+/** output stream appending to a vector									*/
+class growing : public ostream {
+public:
+	explicit inline growing(std::vector<char_t>& buffer) noexcept
+	  : buf(buffer) {}
+	bool put(char_t c) noexcept {
+		buf.push_back(c);
+		return true;
+	}
+	bool write(const char_t* s, size_t n) noexcept {
+		buf.insert(buf.end(), s, s + n);
+		return true;
+	}
+private:
+	std::vector<char_t>& buf;
+};
+
+/**
+ * writes count objects at items with structure S as a JSON array, in
+ * slices of slice objects serialized by n workers into own buffers.
+ * Serialized slices are passed in order to sink(data, size), that returns
+ * false on error. Whichever worker completes the next slice due passes it
+ * and all completed slices after it, thus sink is never called
+ * concurrently. Output is identical to the serial writing of the array
+ */
+template<class C, typename F>
+bool gather(const C* items, std::size_t count, const clas<C>& S, F&& sink,
+		unsigned n = workers(), std::size_t slice = 256) {
+	static constexpr char_t open = literal::begin_array;
+	static constexpr char_t close = literal::end_array;
+	if( slice == 0 ) slice = 1;
+	const std::size_t slices = count / slice + (count % slice ? 1 : 0);
+	std::vector<std::vector<char_t>> parts(slices);
+	std::vector<bool> done(slices, false);
+	std::atomic<std::size_t> next(0);
+	std::atomic<bool> good(sink(&open, 1));
+	std::mutex lock;
+	std::size_t due = 0;
+	run(n, [&](unsigned) {
+		for(std::size_t k; good && (k = next.fetch_add(1)) < slices; ) {
+			growing out(parts[k]);
+			const std::size_t first = k * slice;
+			const std::size_t last =
+				count - first > slice ? first + slice : count;
+			bool r = true;
+			for(std::size_t i = first; r && i < last; ++i)
+				r = (i == 0 || out.put(literal::value_separator)) &&
+					S.write(items[i], out);
+			std::lock_guard<std::mutex> guard(lock);
+			if( ! r ) good = false;
+			done[k] = true;
+			for(; good && due < slices && done[due]; ++due) {
+				if( ! sink(parts[due].data(), parts[due].size()) )
+					good = false;
+				std::vector<char_t>().swap(parts[due]);
+			}
+		}
+	});
+	return good && sink(&close, 1);
+}
+
+/** writes array of count objects at items to out, see gather			*/
+template<class C>
+bool write(const C* items, std::size_t count, const clas<C>& S, ostream& out,
+		unsigned n = workers(), std::size_t slice = 256) {
+	return gather(items, count, S, [&out](const char_t* s, std::size_t len) {
+		return out.write(s, len);
+	}, n, slice);
+}
+
+}}
+namespace parallel = details::parallel;
+}
+#endif // COJSON_PARALLEL_HPP_
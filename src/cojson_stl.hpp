@@ -0,0 +1,660 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * cojson_stl.hpp - bindings for standard containers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#ifndef COJSON_STL_HPP_
+#define COJSON_STL_HPP_
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifndef COJSON_HPP_
+#	include "cojson.hpp"
+#endif
+
+/*
+ * Motivation
+ *
+ * On hosts data is often held in standard containers rather than in fixed
+ * arrays. This file provides properties and values bound directly to
+ * std::vector, std::deque, std::list and std::array of scalars or of
+ * objects structured with clas<T>, so that no intermediate copies are needed.
+ * Reading a growable container clears it, keeping its capacity, reserves
+ * room for the items if the array is in the inline window of the stream
+ * and constructs items in place with emplace_back, so that items are
+ * neither copied nor moved. Writing iterates it directly.
+ * Objects with arbitrary member names are bound to dictionaries, maps from
+ * names to values, that keep the names in own arena.
+ * Strings and containers may take their memory from an arena supplied by
+ * the caller, see allocator, so that a document is read without calls to
+ * malloc and is released at once with arena::reset.
+ * Allocation failures of the free store are not handled, as the library
+ * does not use exceptions.
+ */
+
+namespace cojson {
+namespace details {
+namespace stl {
+
+/** scalar item reader/writer												*/
+template<typename T>
+struct scalar {
+	static inline bool read(T& val, lexer& in) noexcept {
+		return reader<T>::read(val, in);
+	}
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return writer<T>::write(val, out);
+	}
+};
+
+/** object item reader/writer												*/
+template<typename T, const clas<T>& S()>
+struct object {
+	static inline bool read(T& val, lexer& in) noexcept {
+		return S().read(val, in);
+	}
+	static inline bool write(const T& val, ostream& out) noexcept {
+		return S().write(val, out);
+	}
+};
+
+/**
+ * growable container L with items read and written by I
+ */
+template<class L, class I>
+struct growable {
+	typedef typename L::value_type T;
+	static bool read(L& dst, lexer& in) noexcept {
+		dst.clear();
+		reserve(dst, in.extent(), 0);
+		return collection<>::read(growable(), dst, in);
+	}
+	static bool write(const L& src, ostream& out) noexcept {
+		return write(src, out, contiguous<L>());
+	}
+	static inline bool null(L& dst) noexcept {
+		dst.clear();
+		return not config::null_is_error;
+	}
+	/** reads item i, constructed in place								*/
+	inline bool read(L& dst, lexer& in, size_t) const noexcept {
+		dst.emplace_back();
+		if( I::read(dst.back(), in) ) return true;
+		dst.pop_back();
+		return in.skip(false);
+	}
+private:
+	/** reserves room for n items in containers that support it			*/
+	template<class U>
+	static inline auto reserve(U& dst, size_t n, int) noexcept
+			-> decltype(dst.reserve(n), void()) {
+		if( n > dst.capacity() && n <= dst.max_size() ) dst.reserve(n);
+	}
+	template<class U>
+	static inline void reserve(U&, size_t, long) noexcept {}
+	template<class U>
+	struct contiguous : std::integral_constant<bool, batched<T>::value &&
+		std::is_same<U, std::vector<T, typename U::allocator_type>>::value> {};
+	static bool write(const L& src, ostream& out, std::true_type) noexcept {
+		return array::numbers(src.data(), src.size(), out);
+	}
+	static bool write(const L& src, ostream& out, std::false_type) noexcept {
+		bool first = true;
+		for(const T& item : src) {
+			if( ! (array::dlm(first, out) && I::write(item, out)) )
+				return false;
+			first = false;
+		}
+		return (! first || out.put(literal::begin_array)) && array::end(out);
+	}
+};
+
+/**
+ * fixed container std::array<T,N> with items read and written by I
+ */
+template<class I, typename T, size_t N>
+struct fixed {
+	typedef std::array<T, N> L;
+	static bool read(L& dst, lexer& in) noexcept {
+		return in.numbers(dst.data(), N) || collection<>::read(fixed(), dst, in);
+	}
+	static bool write(const L& src, ostream& out) noexcept {
+		if( batched<T>::value )
+			return array::numbers(src.data(), N, out);
+		return array::write(fixed(), src, out);
+	}
+	static inline constexpr bool null(L&) noexcept {
+		return not config::null_is_error;
+	}
+	inline bool read(L& dst, lexer& in, size_t i) const noexcept {
+		return ( I::read(dst[i], in) || in.skip(false) ) ? (i < N-1) : false;
+	}
+	inline bool write(const L& src, ostream& out, size_t i) const noexcept {
+		I::write(src[i], out);
+		return i < N-1;
+	}
+};
+
+/** property of class C bound to member V, a container accessed via A	*/
+template<class C, name id, class L, L C::*V, class A>
+const property<C>& member() noexcept {
+	static constexpr struct local final : property<C> {
+		cstring name() const noexcept { return id(); }
+		fragment prefix() const noexcept {
+			return details::prefix<id>::get();
+		}
+		bool read(C& obj, lexer& in) const noexcept {
+			return A::read(obj.*V, in);
+		}
+		bool write(const C& obj, ostream& out) const noexcept {
+			return A::write(obj.*V, out);
+		}
+	} l {};
+	return l;
+}
+
+/** value bound to static container at P, accessed via A					*/
+template<class L, L* P, class A>
+const value& variable() noexcept {
+	static constexpr struct local final : value {
+		bool read(lexer& in) const noexcept {
+			return A::read(*P, in);
+		}
+		bool write(ostream& out) const noexcept {
+			return A::write(*P, out);
+		}
+	} l {};
+	return l;
+}
+
+}} /* namespace details::stl */
+
+/**
+ * std allocator taking memory from an arena. Deallocation is a no-op,
+ * the memory is released with arena::reset. Growing containers leave
+ * their previous storage in the arena, reserve helps to avoid that.
+ * When the arena is exhausted, memory is taken from the free store and
+ * is returned there on deallocation.
+ * Default constructed allocator uses the free store
+ */
+template<typename T>
+struct allocator {
+	typedef T value_type;
+	inline allocator() noexcept : heap(nullptr) {}
+	inline allocator(arena& a) noexcept : heap(&a) {}
+	template<typename U>
+	inline allocator(const allocator<U>& a) noexcept : heap(a.heap) {}
+	inline T* allocate(std::size_t n) noexcept {
+		T* p = heap && n <= heap->capacity() / sizeof(T) ?
+			heap->allocate<T>(static_cast<size_t>(n)) : nullptr;
+		return p ? p : std::allocator<T>().allocate(n);
+	}
+	inline void deallocate(T* p, std::size_t n) noexcept {
+		if( heap == nullptr || ! heap->owns(p) )
+			std::allocator<T>().deallocate(p, n);
+	}
+	template<typename U>
+	inline bool operator==(const allocator<U>& a) const noexcept {
+		return heap == a.heap;
+	}
+	template<typename U>
+	inline bool operator!=(const allocator<U>& a) const noexcept {
+		return heap != a.heap;
+	}
+	arena* heap;
+};
+
+/** string with memory in an arena										*/
+typedef std::basic_string<char_t, std::char_traits<char_t>, allocator<char_t>>
+	string;
+
+/** vector with memory in an arena										*/
+template<typename T>
+using vector = std::vector<T, allocator<T>>;
+
+namespace details {
+
+/**
+ * std::basic_string reader, characters are appended to the destination
+ * as they are read, without intermediate copies. Room for the string is
+ * reserved once if it ends in the inline window, so that a string in an
+ * arena leaves no outgrown blocks behind
+ */
+template<class Tr, class A>
+struct reader<std::basic_string<char_t, Tr, A>> {
+	static bool read(std::basic_string<char_t, Tr, A>& dst, lexer& in)
+			noexcept {
+		ctype ct;
+		if( ! isvalid(ct=in.value(ctype::stringnull)) )
+			return in.skip();
+		dst.clear();
+		if( ct == ctype::null ) return true;
+		dst.reserve(in.remainder());
+		bool first = true;
+		char_t chr;
+		while( (ct=in.string(chr, first)) == ctype::string ) {
+			dst.push_back(chr);
+			first = false;
+		}
+		return ct == ctype::delim;
+	}
+};
+
+template<class Tr, class A>
+struct writer<std::basic_string<char_t, Tr, A>> {
+	static inline bool write(const std::basic_string<char_t, Tr, A>& str,
+			ostream& out) noexcept {
+		return writer<view>::write(view(str.data(), str.size()), out);
+	}
+};
+
+} /* namespace details */
+
+/**
+ * dictionary key - a zero-terminated name, stored in the key arena of
+ * a dictionary
+ */
+struct key {
+	const char_t* name;
+	inline bool operator<(const key& k) const noexcept {
+		return compare(k) < 0;
+	}
+	inline bool operator==(const key& k) const noexcept {
+		return compare(k) == 0;
+	}
+	int compare(const key& k) const noexcept {
+		const char_t* a = name;
+		const char_t* b = k.name;
+		while( *a && *a == *b ) ++a, ++b;
+		return *a < *b ? -1 : *b < *a ? 1 : 0;
+	}
+	/** FNV-1a hash of the name											*/
+	struct hash {
+		std::size_t operator()(const key& k) const noexcept {
+			std::size_t h = sizeof(std::size_t) > 4 ?
+				static_cast<std::size_t>(14695981039346656037ULL) : 2166136261U;
+			const std::size_t prime = sizeof(std::size_t) > 4 ?
+				static_cast<std::size_t>(1099511628211ULL) : 16777619U;
+			for(const char_t* p = k.name; *p; ++p)
+				h = (h ^ static_cast<std::size_t>(*p)) * prime;
+			return h;
+		}
+	};
+};
+
+/** dictionary kinds, selecting the associative container				*/
+struct ordered_keys {};	/* std::map									*/
+struct hashed_keys {};	/* std::unordered_map							*/
+struct sorted_keys {};	/* sorted vector of pairs, cache-friendly lookup	*/
+
+namespace details {
+namespace stl {
+
+/**
+ * arena for dictionary keys. Names are copied into chunks that never
+ * move, clear keeps the chunks for reuse. Given an external arena, names
+ * are placed there instead
+ */
+class keystore {
+public:
+	explicit keystore(size_t size = 256) noexcept
+	  : heap(nullptr), chunk(size), index(0), used(0) {}
+	explicit keystore(arena& a) noexcept
+	  : heap(&a), chunk(0), index(0), used(0) {}
+	const char_t* store(const char_t* name) noexcept {
+		if( heap ) {
+			const char_t* p = name;
+			while( *p && heap->put(*p) ) ++p;
+			const char_t* str = *p ? nullptr : heap->take().data();
+			if( str ) return str;
+			heap->drop(); /* arena is exhausted, fall back to chunks	*/
+		}
+		size_t n = 0;
+		while( name[n] ) ++n;
+		++n;
+		while( index < chunks.size() && chunks[index].size() - used < n ) {
+			++index;
+			used = 0;
+		}
+		if( index == chunks.size() )
+			chunks.emplace_back(n > chunk ? n : chunk);
+		char_t* dst = chunks[index].data() + used;
+		std::copy(name, name + n, dst);
+		used += n;
+		return dst;
+	}
+	inline void clear() noexcept {
+		index = 0;
+		used = 0;
+	}
+private:
+	arena* heap;
+	std::vector<std::vector<char_t>> chunks;
+	size_t chunk;
+	size_t index;
+	size_t used;
+};
+
+/**
+ * flat map - vector of pairs sorted by key
+ */
+template<typename T>
+class flat : public std::vector<std::pair<key, T>> {
+	typedef std::vector<std::pair<key, T>> base;
+public:
+	typedef typename base::iterator iterator;
+	typedef typename base::const_iterator const_iterator;
+	iterator find(const key& k) noexcept {
+		iterator i = lower(k);
+		return i != base::end() && i->first == k ? i : base::end();
+	}
+	const_iterator find(const key& k) const noexcept {
+		return const_cast<flat*>(this)->find(k);
+	}
+	std::pair<iterator, bool> emplace(const key& k, T&& val) noexcept {
+		iterator i = lower(k);
+		if( i != base::end() && i->first == k )
+			return std::make_pair(i, false);
+		return std::make_pair(base::emplace(i, k, std::move(val)), true);
+	}
+private:
+	inline iterator lower(const key& k) noexcept {
+		return std::lower_bound(base::begin(), base::end(), k,
+			[](const std::pair<key, T>& e, const key& k) noexcept {
+				return e.first < k;
+			});
+	}
+};
+
+template<typename T, class K>
+struct mapping;
+
+template<typename T>
+struct mapping<T, ordered_keys> {
+	typedef std::map<key, T> type;
+};
+
+template<typename T>
+struct mapping<T, hashed_keys> {
+	typedef std::unordered_map<key, T, key::hash> type;
+};
+
+template<typename T>
+struct mapping<T, sorted_keys> {
+	typedef flat<T> type;
+};
+
+}} /* namespace details::stl */
+
+/**
+ * dictionary of values T, keyed by names stored in own arena.
+ * K selects the container: ordered_keys, hashed_keys or sorted_keys.
+ * Keys refer to the arena, therefore dictionaries are not copyable
+ */
+template<typename T, class K = ordered_keys>
+class dictionary : public details::stl::mapping<T, K>::type {
+	typedef typename details::stl::mapping<T, K>::type base;
+public:
+	typedef T mapped_type;
+	dictionary() noexcept {}
+	/** dictionary keeping the names in the external arena a			*/
+	explicit dictionary(arena& a) noexcept : keys(a) {}
+	dictionary(dictionary&&) = default;
+	dictionary& operator=(dictionary&&) = default;
+	dictionary(const dictionary&) = delete;
+	dictionary& operator=(const dictionary&) = delete;
+	/** returns the value with given name, inserting it if not present	*/
+	T& operator[](const char_t* name) noexcept {
+		auto i = base::find(key{name});
+		if( i == base::end() )
+			i = base::emplace(key{keys.store(name)}, T()).first;
+		return i->second;
+	}
+	/** returns name as kept in the dictionary, storing a copy if needed	*/
+	const char_t* keep(const char_t* name) noexcept {
+		auto i = base::find(key{name});
+		return i == base::end() ? keys.store(name) : i->first.name;
+	}
+	/** sets the value with name returned by keep, inserting it if needed	*/
+	T& assign(const char_t* kept, T&& val) noexcept {
+		auto i = base::find(key{kept});
+		if( i == base::end() )
+			return base::emplace(key{kept}, std::move(val)).first->second;
+		return i->second = std::move(val);
+	}
+	void clear() noexcept {
+		base::clear();
+		keys.clear();
+	}
+private:
+	details::stl::keystore keys;
+};
+
+namespace details {
+namespace stl {
+
+/**
+ * dictionary D with values read and written by I
+ */
+template<class D, class I>
+struct keyed {
+	static bool read(D& dst, lexer& in) noexcept {
+		dst.clear();
+		return collection<indexer>::read(keyed(), dst, in);
+	}
+	static bool write(const D& src, ostream& out) noexcept {
+		bool first = true;
+		for(const auto& entry : src) {
+			if( ! (details::object::dlm(first, out) &&
+				   writer<const char_t*>::write(entry.first.name, out) &&
+				   out.put(literal::name_separator) &&
+				   I::write(entry.second, out)) )
+				return false;
+			first = false;
+		}
+		return (! first || out.put(literal::begin_object))
+			&& details::object::end(out);
+	}
+	static inline bool null(D& dst) noexcept {
+		dst.clear();
+		return not config::null_is_error;
+	}
+	/**
+	 * reads value of member name, the entry is set only if it is read.
+	 * The name is kept before reading, as nested members reuse its buffer
+	 */
+	inline bool read(D& dst, lexer& in, const char_t* name) const noexcept {
+		const char_t* kept = dst.keep(name);
+		typename D::mapped_type val {};
+		if( ! I::read(val, in) ) return false;
+		dst.assign(kept, std::move(val));
+		return true;
+	}
+};
+
+}} /* namespace details::stl */
+
+/**
+ * class property std::vector<T>
+ */
+template<class C, details::name id, typename T, std::vector<T> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::vector<T>, V,
+		details::stl::growable<std::vector<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * class property std::vector<T> of objects structured with S
+ */
+template<class C, details::name id, typename T, std::vector<T> C::*V,
+	const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::vector<T>, V,
+		details::stl::growable<std::vector<T>, details::stl::object<T,S>>>();
+}
+
+/**
+ * class property vector<T> with memory in an arena
+ */
+template<class C, details::name id, typename T, vector<T> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, vector<T>, V,
+		details::stl::growable<vector<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * class property vector<T> of objects structured with S
+ */
+template<class C, details::name id, typename T, vector<T> C::*V,
+	const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, vector<T>, V,
+		details::stl::growable<vector<T>, details::stl::object<T,S>>>();
+}
+
+/**
+ * class property std::deque<T>
+ */
+template<class C, details::name id, typename T, std::deque<T> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::deque<T>, V,
+		details::stl::growable<std::deque<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * class property std::deque<T> of objects structured with S
+ */
+template<class C, details::name id, typename T, std::deque<T> C::*V,
+	const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::deque<T>, V,
+		details::stl::growable<std::deque<T>, details::stl::object<T,S>>>();
+}
+
+/**
+ * class property std::list<T>
+ */
+template<class C, details::name id, typename T, std::list<T> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::list<T>, V,
+		details::stl::growable<std::list<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * class property std::list<T> of objects structured with S
+ */
+template<class C, details::name id, typename T, std::list<T> C::*V,
+	const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::list<T>, V,
+		details::stl::growable<std::list<T>, details::stl::object<T,S>>>();
+}
+
+/**
+ * class property std::array<T,N>
+ */
+template<class C, details::name id, typename T, size_t N,
+	std::array<T,N> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::array<T,N>, V,
+		details::stl::fixed<details::stl::scalar<T>, T, N>>();
+}
+
+/**
+ * class property std::array<T,N> of objects structured with S
+ */
+template<class C, details::name id, typename T, size_t N,
+	std::array<T,N> C::*V, const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, std::array<T,N>, V,
+		details::stl::fixed<details::stl::object<T,S>, T, N>>();
+}
+
+/**
+ * class property dictionary<T,K>
+ */
+template<class C, details::name id, typename T, class K,
+	dictionary<T,K> C::*V>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, dictionary<T,K>, V,
+		details::stl::keyed<dictionary<T,K>, details::stl::scalar<T>>>();
+}
+
+/**
+ * class property dictionary<T,K> of objects structured with S
+ */
+template<class C, details::name id, typename T, class K,
+	dictionary<T,K> C::*V, const details::clas<T>& S()>
+const details::property<C>& P() noexcept {
+	return details::stl::member<C, id, dictionary<T,K>, V,
+		details::stl::keyed<dictionary<T,K>, details::stl::object<T,S>>>();
+}
+
+/**
+ * value - static std::vector<T>
+ */
+template<typename T, std::vector<T>* P>
+const details::value& V() noexcept {
+	return details::stl::variable<std::vector<T>, P,
+		details::stl::growable<std::vector<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * value - static std::vector<T> of objects structured with S
+ */
+template<typename T, std::vector<T>* P, const details::clas<T>& S()>
+const details::value& V() noexcept {
+	return details::stl::variable<std::vector<T>, P,
+		details::stl::growable<std::vector<T>, details::stl::object<T,S>>>();
+}
+
+/**
+ * value - static std::deque<T>
+ */
+template<typename T, std::deque<T>* P>
+const details::value& V() noexcept {
+	return details::stl::variable<std::deque<T>, P,
+		details::stl::growable<std::deque<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * value - static std::list<T>
+ */
+template<typename T, std::list<T>* P>
+const details::value& V() noexcept {
+	return details::stl::variable<std::list<T>, P,
+		details::stl::growable<std::list<T>, details::stl::scalar<T>>>();
+}
+
+/**
+ * value - static std::array<T,N>
+ */
+template<typename T, size_t N, std::array<T,N>* P>
+const details::value& V() noexcept {
+	return details::stl::variable<std::array<T,N>, P,
+		details::stl::fixed<details::stl::scalar<T>, T, N>>();
+}
+
+}
+#endif // COJSON_STL_HPP_
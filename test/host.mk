@@ -54,7 +54,8 @@ TESTS-ALL   := $(notdir 													\
   $(TESTS-REST)     														\
 )
 
-host-OBJS   := $(patsubst %.c,%.o,$(TESTS-ALL:.cpp=.o))
+# 106 tests lexers with their own rules, built only with per lexer policy
+host-OBJS   := $(filter-out 106.o,$(patsubst %.c,%.o,$(TESTS-ALL:.cpp=.o)))
 
 wchar-DEFS        := TEST_WCHAR_T
 char16-DEFS       := TEST_CHAR16_T
@@ -62,6 +63,9 @@ char32-DEFS       := TEST_CHAR32_T
 overflow-DEFS     := TEST_OVERFLOW_ERROR
 saturate-DEFS     := TEST_OVERFLOW_SATURATE
 sprintf-DEFS      := TEST_WITH_SPRINTF
+escaped-DEFS      := TEST_NAMES_ESCAPED
+itemized-DEFS     := TEST_INTEGERS_ITEMIZED
+policies-DEFS     := TEST_POLICY_PER_LEXER
 
 wchar-INCLUDES    := $(BASE-DIR)/suites/wchar
 char16-INCLUDES   := $(BASE-DIR)/suites/wchar
@@ -69,15 +73,24 @@ char32-INCLUDES   := $(BASE-DIR)/suites/wchar
 overflow-INCLUDES := $(BASE-DIR)/suites/basic
 saturate-INCLUDES := $(BASE-DIR)/suites/basic
 sprintf-INCLUDES  := $(BASE-DIR)/suites/basic
+escaped-INCLUDES  := $(BASE-DIR)/suites/basic
+itemized-INCLUDES := $(BASE-DIR)/suites/basic
+policies-INCLUDES := $(BASE-DIR)/suites/basic
 
 uchar-OBJS        := $(host-OBJS)
 sprintf-OBJS      := $(host-OBJS)
+escaped-OBJS      := $(host-OBJS)
+itemized-OBJS     := $(host-OBJS)
+policies-OBJS     := $(host-OBJS) 106.o
 wchar-OBJS        := 070.o
 char16-OBJS	      := 071.o
 char32-OBJS	      := 072.o
 overflow-OBJS     := 034.o
 saturate-OBJS     := 034.o
 
+CXX-DEFS := 																\
+  COJSON_SUITE_SIZE=400														\
+
 OBJS := 																	\
   $(COJSON-OBJS)															\
 
@@ -94,6 +107,7 @@ CPPFLAGS += 																\
   -ffunction-sections  														\
   -fdata-sections															\
   -std=c++1y  																\
+  -pthread																	\
 
 
 CFLAGS += 																	\
@@ -108,6 +122,7 @@ CFLAGS += 																	\
 
 LDFLAGS +=																	\
   -s						 												\
+  -pthread																	\
 
 
 .DEFAULT:
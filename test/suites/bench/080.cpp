@@ -55,6 +55,14 @@ static Config080 config2 BENCH_DATA_ATTR;
 
 static nul nil;
 
+#ifdef __AVR__
+/* too small to hold Config, exercises the fallback path */
+static constexpr cojson::size_t outline_steps = 8, outline_text = 64;
+#else
+static constexpr cojson::size_t outline_steps = 160, outline_text = 1600;
+#endif
+static constexpr bool outline_fits = outline_steps >= 160;
+
 static inline ostream& output(const Environment& env) noexcept {
 	return env.isbenchmark() ? (ostream&)nil : (ostream&)env.output;
 }
@@ -124,6 +132,12 @@ Test080 Test080::tests[] = {
 		config2.clear();
 		return config2.run(env, cstring(Test080::datain));
 	}),
+	RUN("benchmarking: writing Config via outline", {
+		static details::outline<Config COMMA outline_steps COMMA outline_text>
+			outline(Config::structure());
+		bool pass = outline.write(config1, output(env)) &&
+			outline.compiled() == outline_fits;
+		return _R(pass, error_t::noerror, env) ; }),
 };
 
 reader<ip4_t> reader<ip4_t>::unit __attribute__((weak));
@@ -131,7 +145,7 @@ reader<ip4_t> reader<ip4_t>::unit __attribute__((weak));
 #undef  _T_
 #define _T_ (8000)
 static cstring const Master[std::extent<decltype(Test080::tests)>::value] = {
-	_P_(0), cstring(nullptr), _P_(2), _P_(3), _P_(4)
+	_P_(0), cstring(nullptr), _P_(2), _P_(3), _P_(4), _P_(3)
 };
 
 #ifdef __AVR__
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 103.cpp - cojson tests, table-driven schema
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+
+#include <stddef.h>
+#include "test.hpp"
+
+struct Test103 : Test {
+	static Test103 tests[];
+	inline Test103(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Item {
+	short id;
+	char_t name[8];
+	bool on;
+};
+
+struct Doc {
+	int a;
+	unsigned char b;
+	long long c;
+	double d;
+	char_t s[16];
+	short v[3];
+	Item items[2];
+	Item one;
+	float f;
+};
+
+struct Name {
+	NAME(a)
+	NAME(b)
+	NAME(c)
+	NAME(d)
+	NAME(s)
+	NAME(v)
+	NAME(items)
+	NAME(one)
+	NAME(f)
+	NAME(id)
+	NAME(name)
+	NAME(on)
+};
+
+/* items are described with constant names, written with prefixes		*/
+static constexpr details::descriptor item_table[] = {
+	D<decltype(Item::id),   Name::id>  (offsetof(Item, id)),
+	D<decltype(Item::name), Name::name>(offsetof(Item, name)),
+	D<decltype(Item::on),   Name::on>  (offsetof(Item, on)),
+};
+
+static constexpr details::descriptor doc_table[] = {
+	D<decltype(Doc::a)>    (Name::a,     offsetof(Doc, a)),
+	D<decltype(Doc::b)>    (Name::b,     offsetof(Doc, b)),
+	D<decltype(Doc::c)>    (Name::c,     offsetof(Doc, c)),
+	D<decltype(Doc::d)>    (Name::d,     offsetof(Doc, d)),
+	D<decltype(Doc::s)>    (Name::s,     offsetof(Doc, s)),
+	D<decltype(Doc::v)>    (Name::v,     offsetof(Doc, v)),
+	D<decltype(Doc::items)>(Name::items, offsetof(Doc, items), item_table),
+	D<decltype(Doc::one), Name::one>(offsetof(Doc, one), item_table),
+	D<decltype(Doc::f)>    (Name::f,     offsetof(Doc, f)),
+};
+
+static constexpr details::table<Doc> structure(doc_table);
+
+static Doc doc;
+
+static inline result_t _R(bool pass, const Environment& env) noexcept {
+	return combine1(pass, test::json().error(), env.output.error());
+}
+
+#define RUN(name, body) Test103(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test103 Test103::tests[] = {
+	RUN("table-driven schema: reading/writing object", {
+		memset(&doc, 0, sizeof(doc));
+		bool pass = structure.read(doc, test::json(
+			"{\"f\":0.5,\"a\":-7,\"b\":200,\"c\":-1234567890123,\"d\":2.5,"
+			"\"s\":\"text\",\"v\":[1,2,3],\"x\":[true],"
+			"\"items\":[{\"id\":1,\"name\":\"one\",\"on\":true},"
+			"{\"on\":false,\"name\":\"two\",\"id\":2}],"
+			"\"one\":{\"id\":3}}"));
+		pass = pass && structure.write(doc, env.output);
+		return _R(pass, env);
+	}),
+	RUN("table-driven schema: array overrun", {
+		memset(&doc, 0, sizeof(doc));
+		bool pass = structure.read(doc, test::json("{\"v\":[4,5,6,7],\"a\":1}"));
+		pass = pass && structure.write(doc, env.output);
+		return _R(pass, env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10300)
+static cstring const Master[details::countof(Test103::tests)] = {
+	_P_(0), _P_(1)
+};
+#include "103.inc"
+
+cstring Test103::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 104.cpp - cojson tests, re-entrant parsing
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+
+#include "test.hpp"
+
+struct Test104 : Test {
+	static Test104 tests[];
+	inline Test104(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Outer {
+	int first;
+	int second;
+	struct Name {
+		NAME(first)
+		NAME(second)
+	};
+	static const clas<Outer>& structure() noexcept {
+		return O<Outer,
+			P<Outer, Name::first,  int, &Outer::first>,
+			P<Outer, Name::second, int, &Outer::second>
+		>();
+	}
+};
+
+struct Inner {
+	int value;
+	struct Name {
+		NAME(value)
+	};
+	static const clas<Inner>& structure() noexcept {
+		return O<Inner,
+			P<Inner, Name::value,  int, &Inner::value>
+		>();
+	}
+};
+
+static Outer outer;
+static Inner inner;
+static bool inner_pass;
+
+/**
+ * input stream that runs another parse, as an ISR would do,
+ * when the outer lexer is in the middle of reading a member name
+ */
+struct interrupting : istream {
+	interrupting(const char_t* str, cojson::size_t at) noexcept
+	  : data(str), pos(0), when(at) { clear(); }
+	bool get(char_t& c) noexcept {
+		if( data[pos] == 0 ) {
+			c = iostate::eos_c;
+			error(error_t::eof);
+			return false;
+		}
+		if( pos == when ) interrupt();
+		c = data[pos++];
+		return true;
+	}
+	static void interrupt() noexcept {
+		char_t scratch[16];
+		details::buffer in("{\"value\":42}");
+		lexer lex(in, scratch);
+		inner_pass = Inner::structure().read(inner, lex);
+	}
+private:
+	const char_t* data;
+	cojson::size_t pos;
+	cojson::size_t when;
+};
+
+static inline result_t _R(bool pass, error_t err, const Environment& env) noexcept {
+	return combine1(pass, err, env.output.error());
+}
+
+#define RUN(name, body) Test104(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test104 Test104::tests[] = {
+	RUN("re-entrant parsing: nested parse with separate scratch", {
+		char_t scratch[16];
+		interrupting in("{\"first\":1,\"second\":2}", 5);
+		lexer lex(in, scratch);
+		outer.first = outer.second = inner.value = 0;
+		inner_pass = false;
+		bool pass = Outer::structure().read(outer, lex) && inner_pass;
+		pass = pass && Outer::structure().write(outer, env.output)
+			&& Inner::structure().write(inner, env.output);
+		return _R(pass, lex.error(), env);
+	}),
+	RUN("re-entrant parsing: longest name fitting scratch", {
+		char_t scratch[sizeof("second")];
+		details::buffer in("{\"second\":3,\"first\":4}");
+		lexer lex(in, scratch);
+		outer.first = outer.second = 0;
+		bool pass = Outer::structure().read(outer, lex);
+		pass = pass && Outer::structure().write(outer, env.output);
+		return _R(pass, lex.error(), env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10400)
+static cstring const Master[details::countof(Test104::tests)] = {
+	_P_(0), _P_(1)
+};
+#include "104.inc"
+
+cstring Test104::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 105.cpp - cojson tests, inline stream window
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test105 : Test {
+	static Test105 tests[];
+	inline Test105(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Sample {
+	char_t name[16];
+	short list[4];
+	long total;
+	struct Name {
+		NAME(name)
+		NAME(list)
+		NAME(total)
+	};
+	static const clas<Sample>& structure() noexcept {
+		return O<Sample,
+			P<Sample, Name::name, countof(&Sample::name), &Sample::name>,
+			P<Sample, Name::list, short, countof(&Sample::list), &Sample::list>,
+			P<Sample, Name::total, long, &Sample::total>
+		>();
+	}
+};
+
+static Sample sample;
+
+static void fill(Sample& s) noexcept {
+	static const Sample filled = { "target", { 5, -6, 7, -8 }, 9876543 };
+	s = filled;
+}
+
+static inline result_t _R(bool pass, error_t err, const Environment& env) noexcept {
+	return combine1(pass, err, env.output.error());
+}
+
+#define RUN(name, body) Test105(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test105 Test105::tests[] = {
+	RUN("inline window: reading from source", {
+		memset(&sample, 0, sizeof(sample));
+		details::source in(
+			"{\"total\":-1234567,\"list\":[1,-2,3,-4],\"name\":\"sample\"}");
+		bool pass = Sample::structure().read(sample, in);
+		pass = pass && Sample::structure().write(sample, env.output);
+		return _R(pass, in.error() & ~error_t::eof, env);
+	}),
+	RUN("inline window: sized source, restart", {
+		memset(&sample, 0, sizeof(sample));
+		static const char_t data[] = "{\"total\":7}{\"total\":8}";
+		details::source in(data, 11);
+		bool pass = Sample::structure().read(sample, in);
+		in.restart();
+		sample.total = 0;
+		pass = pass && Sample::structure().read(sample, in)
+			&& in.count() == 11;
+		pass = pass && Sample::structure().write(sample, env.output);
+		return _R(pass, in.error() & ~error_t::eof, env);
+	}),
+	RUN("inline window: truncated input", {
+		memset(&sample, 0, sizeof(sample));
+		details::source in("{\"total\":7,\"name\":\"sam");
+		bool pass = Sample::structure().read(sample, in);
+		return _R(!pass, error_t::noerror, env);
+	}),
+	RUN("inline window: cleared stream resumes", {
+		details::source in("  7");
+		details::lexer lex(in);
+		char_t chr = 0;
+		lex.error(error_t::bad);
+		bool pass = ! lex.skipws(chr);
+		in.clear();
+		pass = pass && lex.skipws(chr) && chr == '7';
+		return _R(pass, in.error() & ~error_t::eof, env);
+	}),
+	RUN("put area: writing to target", {
+		fill(sample);
+		char_t data[64];
+		details::target out(data);
+		bool pass = Sample::structure().write(sample, out);
+		pass = pass && env.output.write(data, out.count());
+		return _R(pass, out.error(), env);
+	}),
+	RUN("put area: target overflow", {
+		fill(sample);
+		char_t data[16];
+		details::target out(data);
+		bool pass = ! Sample::structure().write(sample, out)
+			&& out.count() == 16 && out.eof();
+		out.restart();
+		pass = pass && out.count() == 0 && out.emit('x');
+		return _R(pass, out.error(), env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10500)
+static cstring const Master[details::countof(Test105::tests)] = {
+	_P_(0), _P_(1), cstring(nullptr), cstring(nullptr), _P_(4),
+	cstring(nullptr)
+};
+#include "105.inc"
+
+cstring Test105::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 106.cpp - cojson tests, coexisting parsing policies
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+
+#include "test.hpp"
+
+struct Test106 : Test {
+	static Test106 tests[];
+	inline Test106(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct strict : config {
+	static constexpr auto overflow = overflow_is::error;
+	static constexpr auto mismatch = mismatch_is::error;
+};
+
+struct lenient : config {
+	static constexpr auto overflow = overflow_is::saturated;
+	static constexpr auto mismatch = mismatch_is::skipped;
+};
+
+struct Bytes {
+	unsigned char a;
+	unsigned char b;
+	struct Name {
+		NAME(a)
+		NAME(b)
+	};
+	static const clas<Bytes>& structure() noexcept {
+		return O<Bytes,
+			P<Bytes, Name::a, unsigned char, &Bytes::a>,
+			P<Bytes, Name::b, unsigned char, &Bytes::b>
+		>();
+	}
+};
+
+static Bytes bytes;
+
+static result_t parse(const Environment& env, policy rules) noexcept {
+	bytes.a = bytes.b = 0;
+	details::source in("{\"a\":300,\"c\":{},\"b\":7}");
+	lexer lex(in, rules);
+	Bytes::structure().read(bytes, lex);
+	error_t err = lex.error();
+	bool pass = Bytes::structure().write(bytes, env.output);
+	return combine1(pass, err, env.output.error());
+}
+
+#define RUN(name, body) Test106(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test106 Test106::tests[] = {
+	RUN("coexisting policies: lenient", {
+		return parse(env, policy::of<lenient>());
+	}),
+	RUN("coexisting policies: strict", {
+		result_t r = parse(env, policy::of<strict>());
+		return r == combinu(0, error_t::overflow) ? success : r;
+	}),
+	RUN("coexisting policies: default", {
+		return parse(env, policy::of());
+	}),
+};
+
+#undef  _T_
+#define _T_ (10600)
+static cstring const Master[details::countof(Test106::tests)] = {
+	_P_(0), _P_(1), _P_(2)
+};
+#include "106.inc"
+
+cstring Test106::master() const noexcept {
+	return Master[index()];
+}
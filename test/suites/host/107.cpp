@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 107.cpp - cojson tests, compile-time presets
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+
+struct Test107 : Test {
+	static Test107 tests[];
+	inline Test107(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Point {
+	short x;
+	short y;
+	struct Name {
+		NAME(x)
+		NAME(y)
+	};
+	typedef K<Point, Name::x, short, &Point::x> X;
+	typedef K<Point, Name::y, short, &Point::y> Y;
+};
+
+struct Preset {
+	char_t name[12];
+	unsigned char level;
+	long total;
+	bool enabled;
+	double ratio;
+	short list[3];
+	Point origin;
+	Point path[2];
+	struct Name {
+		NAME(name)
+		NAME(level)
+		NAME(total)
+		NAME(enabled)
+		NAME(ratio)
+		NAME(list)
+		NAME(origin)
+		NAME(path)
+	};
+	typedef K<Preset, Name::name, char_t[12], &Preset::name> Label;
+	typedef K<Preset, Name::level, unsigned char, &Preset::level> Level;
+	typedef K<Preset, Name::total, long, &Preset::total> Total;
+	typedef K<Preset, Name::enabled, bool, &Preset::enabled> Enabled;
+	typedef K<Preset, Name::ratio, double, &Preset::ratio> Ratio;
+	typedef K<Preset, Name::list, short[3], &Preset::list> List;
+	typedef K<Preset, Name::origin, Point, &Preset::origin,
+		Point::X, Point::Y> Origin;
+	typedef K<Preset, Name::path, Point[2], &Preset::path,
+		Point::X, Point::Y> Path;
+
+	static const clas<Preset>& structure() noexcept {
+		return O<Preset, Label, Level, Total, Enabled, Ratio, List,
+			Origin, Path>();
+	}
+	static constexpr Preset defaults() noexcept {
+		return preset<Preset, Label, Level, Total, Enabled, Ratio, List,
+			Origin, Path>(
+			"{ \"name\" : \"pre\\tset\", \"level\":200, \"total\":-1234567,"
+			"\"enabled\":true, \"ratio\":2.5e-1, \"list\":[1,-2,3],"
+			"\"unknown\":{\"a\":[null,false,\"]\"]},"
+			"\"origin\":{\"x\":-3,\"y\":4}, \"path\":[{\"x\":1},{\"y\":2}],"
+			"\"ratio\":null}");
+	}
+};
+
+static constexpr Preset defaults = Preset::defaults();
+static_assert(defaults.level == 200, "preset level");
+static_assert(defaults.origin.y == 4 && defaults.path[1].y == 2,
+	"preset nested objects");
+static_assert(defaults.name[3] == '\t', "preset escaped string");
+
+static Preset sample;
+
+static inline result_t _R(bool pass, error_t err, const Environment& env) noexcept {
+	return combine1(pass, err, env.output.error());
+}
+
+#define RUN(name, body) Test107(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test107 Test107::tests[] = {
+	RUN("compile-time preset: writing defaults", {
+		sample = defaults;
+		return _R(Preset::structure().write(sample, env.output),
+			error_t::noerror, env);
+	}),
+	RUN("compile-time preset: run-time update", {
+		sample = defaults;
+		details::source in("{\"level\":7,\"list\":[9],\"origin\":{\"y\":-1}}");
+		bool pass = Preset::structure().read(sample, in);
+		pass = pass && Preset::structure().write(sample, env.output);
+		return _R(pass, in.error() & ~error_t::eof, env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10700)
+static cstring const Master[details::countof(Test107::tests)] = {
+	_P_(0), _P_(1)
+};
+#include "107.inc"
+
+cstring Test107::master() const noexcept {
+	return Master[index()];
+}
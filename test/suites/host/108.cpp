@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 108.cpp - cojson tests, reading arrays of numbers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test108 : Test {
+	static Test108 tests[];
+	inline Test108(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Samples {
+	short adc[6];
+	long long wide[3];
+	unsigned long long uwide[2];
+	signed char tiny[3];
+	struct Name {
+		NAME(adc)
+		NAME(wide)
+		NAME(uwide)
+		NAME(tiny)
+	};
+	static const clas<Samples>& structure() noexcept {
+		return O<Samples,
+			P<Samples, Name::adc, short, countof(&Samples::adc), &Samples::adc>,
+			P<Samples, Name::wide, long long, countof(&Samples::wide),
+				&Samples::wide>,
+			P<Samples, Name::uwide, unsigned long long,
+				countof(&Samples::uwide), &Samples::uwide>,
+			P<Samples, Name::tiny, signed char, countof(&Samples::tiny),
+				&Samples::tiny>
+		>();
+	}
+};
+
+static Samples windowed, generic;
+static unsigned hist[5];
+static long data[100], back[100];
+static char_t text[1500];
+
+/* reads input via inline window and via plain get, expecting same results */
+static result_t same(const Environment& env, cstring inp) noexcept {
+	memset(&windowed, 0, sizeof(windowed));
+	memset(&generic, 0, sizeof(generic));
+	details::source in(inp);
+	lexer lex(in);
+	Samples::structure().read(windowed, lex);
+	Samples::structure().read(generic, json(inp));
+	bool pass = memcmp(&windowed, &generic, sizeof(windowed)) == 0;
+	pass = pass && Samples::structure().write(windowed, env.output);
+	return combine1(pass,
+		lex.error() == json().error() ? error_t::noerror : lex.error(),
+		env.output.error());
+}
+
+static result_t histogram(const Environment& env) noexcept {
+	memset(hist, 0, sizeof(hist));
+	details::source in("[10, 20,30 ,40,50]");
+	lexer lex(in);
+	bool pass = V<unsigned, countof(hist), hist>().read(lex)
+		&& hist[4] == 50 && in.count() == 18;
+	pass = pass && V<unsigned, countof(hist), hist>().write(env.output);
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+/* writes a long array in batches and reads it back */
+static result_t roundtrip(const Environment& env) noexcept {
+	for(int i = 0; i < 100; ++i)
+		data[i] = (i & 1 ? -1L : 1L) * i * i * i * 2011L;
+	memset(back, 0, sizeof(back));
+	details::buffer out(text);
+	bool pass = V<long, countof(data), data>().write(out) && out.put(0);
+	details::source in(text);
+	lexer lex(in);
+	pass = pass && V<long, countof(back), back>().read(lex)
+		&& memcmp(data, back, sizeof(data)) == 0;
+	env.out(pass, "%s\n", text);
+	return combine1(pass, lex.error(), out.error());
+}
+
+/* user defined vector accessor, declaring no extent					*/
+struct odd {
+	typedef int clas;
+	typedef int type;
+	static constexpr bool canget = true;
+	static constexpr bool canset = true;
+	static constexpr bool canlref   = true;
+	static constexpr bool canrref   = true;
+	static constexpr bool is_vector = true;
+	static int items[3];
+	static inline bool has(cojson::size_t i) noexcept { return i < 3; }
+	static inline int get(cojson::size_t i) noexcept { return items[i]; }
+	static inline int& lref(cojson::size_t i) noexcept { return items[i]; }
+	static inline const int& rref(cojson::size_t i) noexcept { return items[i]; }
+	static inline void set(cojson::size_t i, int v) noexcept { items[i] = v; }
+	static inline void init(int&) noexcept {}
+	static inline constexpr bool null(cojson::void_t) noexcept {
+		return true;
+	}
+};
+int odd::items[3];
+
+static result_t accessed(const Environment& env) noexcept {
+	static constexpr details::vector<odd> items {};
+	details::source in("[7,-8,9]");
+	lexer lex(in);
+	bool pass = details::vector<odd>::extent == 0 && items.read(lex)
+		&& odd::items[2] == 9 && items.write(env.output);
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+struct Reals {
+	double r[4];
+	struct Name {
+		NAME(r)
+	};
+	static const clas<Reals>& structure() noexcept {
+		return O<Reals,
+			P<Reals, Name::r, double, countof(&Reals::r), &Reals::r>
+		>();
+	}
+};
+
+/* doubles read via inline window and via plain get are bitwise equal	*/
+static result_t reals(const Environment&, cstring inp, double last) noexcept {
+	Reals a, b;
+	memset(&a, 0, sizeof(a));
+	memset(&b, 0, sizeof(b));
+	details::source in(inp);
+	lexer lex(in);
+	Reals::structure().read(a, lex);
+	Reals::structure().read(b, json(inp));
+	bool pass = memcmp(&a, &b, sizeof(a)) == 0 &&
+		a.r[3] > last - 1e-9 && a.r[3] < last + 1e-9;
+	return combine1(pass,
+		lex.error() == json().error() ? error_t::noerror : lex.error());
+}
+
+#define RUN(name, body) Test108(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test108 Test108::tests[] = {
+	RUN("numbers: plain integers", {
+		return same(env,
+			"{\"adc\":[ 1, -32768 ,32767,\n0,\t-5 ,12],"
+			"\"wide\":[9223372036854775807,-9223372036854775808,"
+				"-1234567890123456],"
+			"\"uwide\":[18446744073709551615,12345678],"
+			"\"tiny\":[-128,127,0]}");
+	}),
+	RUN("numbers: empty and short arrays", {
+		return same(env, "{\"adc\":[],\"wide\":[ ],\"tiny\":[1]}");
+	}),
+	RUN("numbers: fallback", {
+		return same(env,
+			"{\"adc\":[1,2,3,4,5,6,7],\"wide\":[1,null,3],"
+			"\"uwide\":[18446744073709551616,-1],\"tiny\":[1,128,2]}");
+	}),
+	RUN("numbers: value array", {
+		return histogram(env);
+	}),
+	RUN("numbers: batch write round trip", {
+		return roundtrip(env);
+	}),
+	RUN("numbers: accessor without extent", {
+		return accessed(env);
+	}),
+	RUN("numbers: doubles", {
+		return reals(env, "{\"r\":[1.5, -2e3 ,0.125,\n3E-2]}", 0.03);
+	}),
+	RUN("numbers: doubles fallback", {
+		return reals(env, "{\"r\":[1.5,2.5,3.5,-0.25e1,7]}", -2.5);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10800)
+static cstring const Master[details::countof(Test108::tests)] = {
+	_P_(0), _P_(1), _P_(2), _P_(3), cstring(nullptr), _P_(5),
+	cstring(nullptr), cstring(nullptr)
+};
+#include "108.inc"
+
+cstring Test108::master() const noexcept {
+	return Master[index()];
+}
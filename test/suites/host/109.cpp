@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 109.cpp - cojson tests, standard containers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "cojson_stl.hpp"
+#include "test.hpp"
+
+struct Test109 : Test {
+	static Test109 tests[];
+	inline Test109(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Point {
+	short x;
+	short y;
+	struct Name {
+		NAME(x)
+		NAME(y)
+	};
+	static const clas<Point>& structure() noexcept {
+		return O<Point,
+			P<Point, Name::x, short, &Point::x>,
+			P<Point, Name::y, short, &Point::y>
+		>();
+	}
+};
+
+struct Containers {
+	std::vector<int> samples;
+	std::deque<double> levels;
+	std::list<short> marks;
+	std::array<long, 3> totals;
+	std::vector<Point> path;
+	std::array<Point, 2> box;
+	struct Name {
+		NAME(samples)
+		NAME(levels)
+		NAME(marks)
+		NAME(totals)
+		NAME(path)
+		NAME(box)
+	};
+	static const clas<Containers>& structure() noexcept {
+		return O<Containers,
+			P<Containers, Name::samples, int, &Containers::samples>,
+			P<Containers, Name::levels, double, &Containers::levels>,
+			P<Containers, Name::marks, short, &Containers::marks>,
+			P<Containers, Name::totals, long, 3, &Containers::totals>,
+			P<Containers, Name::path, Point, &Containers::path,
+				Point::structure>,
+			P<Containers, Name::box, Point, 2, &Containers::box,
+				Point::structure>
+		>();
+	}
+};
+
+static Containers containers;
+static std::vector<unsigned> bins;
+
+static const char_t full[] =
+	"{\"samples\":[1,-2,3,-4,5],\"levels\":[0.5,1.5],"
+	"\"marks\":[7,8,9],\"totals\":[10,20,30],"
+	"\"path\":[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4},{\"y\":6}],"
+	"\"box\":[{\"x\":-1,\"y\":-2},{\"x\":1,\"y\":2}]}";
+
+static result_t members(const Environment& env, cstring inp) noexcept {
+	containers = Containers();
+	details::source in(full);
+	bool pass = Containers::structure().read(containers, in);
+	/* vectors in the window are reserved to size */
+	pass = pass && containers.samples.capacity() == 5
+		&& containers.path.capacity() == 3;
+	if( inp != nullptr ) {
+		in.set(inp);
+		pass = pass && Containers::structure().read(containers, in);
+	}
+	pass = pass && Containers::structure().write(containers, env.output);
+	return combine1(pass, in.error() & ~details::error_t::eof,
+		env.output.error());
+}
+
+static result_t statics(const Environment& env) noexcept {
+	bins.assign(10, 0);
+	bool pass = V<unsigned, &bins>().read(json("[ 3, 1, 4, 1, 5 ]"))
+		&& bins.size() == 5;
+	pass = pass && V<unsigned, &bins>().write(env.output);
+	return combine1(pass, json().error(), env.output.error());
+}
+
+#define RUN(name, body) Test109(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test109 Test109::tests[] = {
+	RUN("standard containers: reading and writing", {
+		return members(env, nullptr);
+	}),
+	RUN("standard containers: rereading and empty", {
+		return members(env,
+			"{\"samples\":[ ],\"levels\":null,\"marks\":[1],"
+			"\"path\":[{\"x\":5,\"y\":5}]}");
+	}),
+	RUN("standard containers: static vector", {
+		return statics(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (10900)
+static cstring const Master[details::countof(Test109::tests)] = {
+	_P_(0), _P_(1), _P_(2)
+};
+#include "109.inc"
+
+cstring Test109::master() const noexcept {
+	return Master[index()];
+}
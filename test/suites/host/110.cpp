@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 110.cpp - cojson tests, dictionaries
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "cojson_stl.hpp"
+#include "test.hpp"
+
+struct Test110 : Test {
+	static Test110 tests[];
+	inline Test110(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Counters {
+	unsigned long rx;
+	unsigned long tx;
+	struct Name {
+		NAME(rx)
+		NAME(tx)
+	};
+	static const clas<Counters>& structure() noexcept {
+		return O<Counters,
+			P<Counters, Name::rx, unsigned long, &Counters::rx>,
+			P<Counters, Name::tx, unsigned long, &Counters::tx>
+		>();
+	}
+};
+
+struct Stats {
+	dictionary<Counters> interfaces;
+	dictionary<int, sorted_keys> levels;
+	dictionary<short, hashed_keys> ports;
+	struct Name {
+		NAME(interfaces)
+		NAME(levels)
+		NAME(ports)
+	};
+	static const clas<Stats>& structure() noexcept {
+		return O<Stats,
+			P<Stats, Name::interfaces, Counters, ordered_keys,
+				&Stats::interfaces, Counters::structure>,
+			P<Stats, Name::levels, int, sorted_keys, &Stats::levels>,
+			P<Stats, Name::ports, short, hashed_keys, &Stats::ports>
+		>();
+	}
+};
+
+static Stats stats;
+
+static result_t read(const Environment& env, cstring inp) noexcept {
+	details::source in(inp);
+	bool pass = Stats::structure().read(stats, in);
+	pass = pass && Stats::structure().write(stats, env.output);
+	return combine1(pass, in.error() & ~details::error_t::eof,
+		env.output.error());
+}
+
+static result_t lookup(const Environment& env) noexcept {
+	details::source in("{\"ports\":{\"http\":80,\"ssh\":22,\"dns\":53},"
+		"\"levels\":{\"z\":1,\"a\":2,\"m\":3,\"a\":4}}");
+	bool pass = Stats::structure().read(stats, in)
+		&& stats.ports.size() == 3 && stats.ports["ssh"] == 22
+		&& stats.ports["dns"] == 53 && stats.levels.size() == 3
+		&& stats.levels.find(key{"a"})->second == 4
+		&& stats.levels.begin()->first == key{"a"};
+	return combine1(pass, in.error() & ~details::error_t::eof,
+		env.output.error());
+}
+
+/* entries whose values fail to read are not inserted					*/
+static result_t failed(const Environment&) noexcept {
+	details::source in("{\"levels\":{\"a\":1,\"b\":\"text\",\"c\":3}}");
+	Stats::structure().read(stats, in);
+	bool pass = stats.levels.find(key{"b"}) == stats.levels.end()
+		&& stats.levels.find(key{"a"})->second == 1;
+	return combine1(pass);
+}
+
+#define RUN(name, body) Test110(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test110 Test110::tests[] = {
+	RUN("dictionaries: reading and writing", {
+		return read(env,
+			"{\"interfaces\":{\"eth0\":{\"rx\":100,\"tx\":200},"
+			"\"lo\":{\"rx\":5,\"tx\":5},\"\\\"wlan0\\\"\":{\"tx\":7}},"
+			"\"levels\":{\"warn\":2,\"debug\":0,\"error\":3},"
+			"\"ports\":{\"http\":80}}");
+	}),
+	RUN("dictionaries: empty and null", {
+		return read(env, "{\"interfaces\":{},\"levels\":null,\"ports\":{ }}");
+	}),
+	RUN("dictionaries: lookup", {
+		return lookup(env);
+	}),
+	RUN("dictionaries: failed values", {
+		return failed(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11000)
+static cstring const Master[details::countof(Test110::tests)] = {
+	_P_(0), _P_(1), cstring(nullptr), cstring(nullptr)
+};
+#include "110.inc"
+
+cstring Test110::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 111.cpp - cojson tests, zero-copy string views
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test111 : Test {
+	static Test111 tests[];
+	inline Test111(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Message {
+	view from;
+	view text;
+	int id;
+	struct Name {
+		NAME(from)
+		NAME(text)
+		NAME(id)
+	};
+	static const clas<Message>& structure() noexcept {
+		return O<Message,
+			P<Message, Name::from, view, &Message::from>,
+			P<Message, Name::text, view, &Message::text>,
+			P<Message, Name::id, int, &Message::id>
+		>();
+	}
+};
+
+static Message message;
+static char_t input[1100];
+
+static inline bool within(const view& v) noexcept {
+	return v.null() ||
+		(v.data() >= input && v.end() <= input + sizeof(input));
+}
+
+/* reads message from a mutable copy of json */
+static result_t decode(const Environment& env, const char* json,
+		const char* from, const char* text) noexcept {
+	message = Message();
+	strcpy(input, json);
+	details::inplace in(input);
+	lexer lex(in);
+	bool pass = Message::structure().read(message, lex)
+		&& message.from == from && message.text == text
+		&& within(message.from) && within(message.text);
+	pass = pass && Message::structure().write(message, env.output);
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+/* reads a string longer than any scratch buffer */
+static result_t unlimited(const Environment& env) noexcept {
+	message = Message();
+	strcpy(input, "{\"text\":\"");
+	unsigned n = strlen(input);
+	for(unsigned i = 0; i < 1000; ++i)
+		input[n + i] = 'a' + i % 26;
+	strcpy(input + n + 1000, "\",\"id\":9}");
+	details::inplace in(input);
+	lexer lex(in);
+	bool pass = Message::structure().read(message, lex)
+		&& message.text.size() == 1000 && message.text.data() == input + n
+		&& message.text.end()[-1] == 'a' + 999 % 26 && message.id == 9;
+	env.out(pass, "%u\n", message.text.size());
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+/* constant source can not decode escaped string in place */
+static result_t readonly(const Environment& env) noexcept {
+	message = Message();
+	details::source in("{\"from\":\"bob\",\"text\":\"a\\tb\",\"id\":4}");
+	lexer lex(in);
+	bool pass = Message::structure().read(message, lex)
+		&& message.from == "bob" && message.text.null() && message.id == 4
+		&& lex.error() == error_t::noobject;
+	pass = pass && Message::structure().write(message, env.output);
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test111(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test111 Test111::tests[] = {
+	RUN("view: plain strings", {
+		return decode(env, "{\"from\":\"alice\",\"text\":\"hello\",\"id\":3}",
+			"alice", "hello");
+	}),
+	RUN("view: escaped strings decoded in place", {
+		return decode(env,
+			"{\"from\":\"\\\"q\\\"\",\"text\":\"a\\nb\\u0041\",\"id\":1}",
+			"\"q\"", "a\nbA");
+	}),
+	RUN("view: empty and null", {
+		return decode(env, "{\"from\":null,\"text\":\"\",\"id\":2}",
+			nullptr, "");
+	}),
+	RUN("view: unlimited length", {
+		return unlimited(env);
+	}),
+	RUN("view: escaped string in constant source", {
+		return readonly(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11100)
+static cstring const Master[details::countof(Test111::tests)] = {
+	_P_(0), _P_(1), _P_(2), cstring(nullptr), _P_(4)
+};
+#include "111.inc"
+
+cstring Test111::master() const noexcept {
+	return Master[index()];
+}
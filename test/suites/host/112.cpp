@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 112.cpp - cojson tests, arena for strings and containers
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "cojson_stl.hpp"
+#include "test.hpp"
+
+struct Test112 : Test {
+	static Test112 tests[];
+	inline Test112(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+alignas(8) static char memory[1024];
+static arena heap(memory);
+
+struct Document {
+	view name;
+	cojson::string title;
+	cojson::vector<int> codes;
+	dictionary<int, sorted_keys> limits;
+	Document() noexcept : title(heap), codes(heap), limits(heap) {}
+	struct Name {
+		NAME(name)
+		NAME(title)
+		NAME(codes)
+		NAME(limits)
+	};
+	static const clas<Document>& structure() noexcept {
+		return O<Document,
+			P<Document, Name::name, view, &Document::name>,
+			P<Document, Name::title, cojson::string, &Document::title>,
+			P<Document, Name::codes, int, &Document::codes>,
+			P<Document, Name::limits, int, sorted_keys, &Document::limits>
+		>();
+	}
+};
+
+struct Tag {
+	view name;
+	int id;
+	struct Name {
+		NAME(name)
+		NAME(id)
+	};
+	static const clas<Tag>& structure() noexcept {
+		return O<Tag,
+			P<Tag, Name::name, view, &Tag::name>,
+			P<Tag, Name::id, int, &Tag::id>
+		>();
+	}
+};
+
+static inline bool within(const void* p) noexcept {
+	return p >= memory && p < memory + sizeof(memory);
+}
+
+static cstring const document =
+	"{\"name\":\"a\\tb\",\"title\":\"Title of the document \\u0041\","
+	"\"codes\":[1,2,3],"
+	"\"limits\":{\"rx\":5,\"tx\":6}}";
+
+/* reads a document from a constant source with all memory in the arena */
+static result_t allocated(const Environment& env) noexcept {
+	heap.reset();
+	Document doc;
+	details::source in(document);
+	lexer lex(in);
+	lex.memory(&heap);
+	bool pass = Document::structure().read(doc, lex)
+		&& doc.name == "a\tb" && within(doc.name.data())
+		&& doc.title.size() == 23 && within(doc.title.data())
+		&& doc.codes.size() == 3 && within(doc.codes.data())
+		&& within(doc.limits.begin()->first.name);
+	pass = pass && Document::structure().write(doc, env.output);
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+static unsigned parse() noexcept {
+	heap.reset();
+	Document doc;
+	details::source in(document);
+	lexer lex(in);
+	lex.memory(&heap);
+	return Document::structure().read(doc, lex) ? heap.used() : 0;
+}
+
+/* arena released at once, same document takes same memory */
+static result_t reused(const Environment& env) noexcept {
+	unsigned first = parse();
+	unsigned second = parse();
+	bool pass = first != 0 && first == second;
+	env.out(pass, "%u %u\n", first, second);
+	return combine1(pass);
+}
+
+/* string that does not fit a small arena is skipped */
+static result_t exhausted(const Environment& env) noexcept {
+	char small[12];
+	arena tiny(small);
+	Tag tag = {};
+	details::source in(
+		"{\"name\":\"long\\tname\\tthat\\tdoes\\tnot\\tfit\",\"id\":1,"
+		"\"name\":\"s\\tn\"}");
+	lexer lex(in);
+	lex.memory(&tiny);
+	bool pass = Tag::structure().read(tag, lex)
+		&& tag.id == 1 && tag.name == "s\tn"
+		&& lex.error() == details::error_t::overrun;
+	pass = pass && Tag::structure().write(tag, env.output);
+	return combine1(pass, env.output.error());
+}
+
+/* containers outgrowing the arena continue in the free store */
+typedef details::stl::growable<cojson::vector<int>,
+	details::stl::scalar<int>> items;
+
+static result_t overflown(const Environment& env) noexcept {
+	alignas(8) char small[32];
+	arena tiny(small);
+	cojson::vector<int> codes(tiny);
+	cojson::string title(tiny);
+	details::source in("[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16]");
+	lexer lex(in);
+	bool pass = items::read(codes, lex)
+		&& codes.size() == 16 && ! tiny.owns(codes.data());
+	title.assign(40, 'x');
+	pass = pass && title.size() == 40 && ! tiny.owns(title.data());
+	pass = pass && items::write(codes, env.output);
+	return combine1(pass, lex.error(), env.output.error());
+}
+
+/* strings ending in the window take one block, none outgrown			*/
+static result_t reserved(const Environment&) noexcept {
+	heap.reset();
+	cojson::string plain(heap), escaped(heap);
+	details::source in("[\"string of thirty seven characters....\","
+		"\"string \\u0077ith escapes\\tthat is as long\"]");
+	lexer lex(in);
+	char_t chr;
+	bool pass = lex.skipws(chr) && chr == literal::begin_array
+		&& details::reader<cojson::string>::read(plain, lex)
+		&& plain.size() == 37 && heap.used() == plain.capacity() + 1;
+	const unsigned used = heap.used();
+	pass = pass && lex.skipws(chr) && chr == literal::value_separator
+		&& details::reader<cojson::string>::read(escaped, lex)
+		&& escaped == "string with escapes\tthat is as long"
+		&& heap.used() - used == escaped.capacity() + 1;
+	return combine1(pass, lex.error());
+}
+
+#define RUN(name, body) Test112(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test112 Test112::tests[] = {
+	RUN("arena: strings and containers", {
+		return allocated(env);
+	}),
+	RUN("arena: reset and reuse", {
+		return reused(env);
+	}),
+	RUN("arena: exhausted", {
+		return exhausted(env);
+	}),
+	RUN("arena: outgrown by containers", {
+		return overflown(env);
+	}),
+	RUN("arena: strings reserved", {
+		return reserved(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11200)
+static cstring const Master[details::countof(Test112::tests)] = {
+	_P_(0), cstring(nullptr), _P_(2), _P_(3), cstring(nullptr)
+};
+#include "112.inc"
+
+cstring Test112::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 113.cpp - cojson tests, interned strings
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include "test.hpp"
+
+struct Test113 : Test {
+	static Test113 tests[];
+	inline Test113(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+static symbols<16, 128> names;
+static symbols<2, 16> few;
+
+static pool& interned() noexcept { return names; }
+static pool& limited() noexcept { return few; }
+
+struct Network {
+	symbol ifname;
+	symbol encryption;
+	signed char quality;
+	struct Name {
+		NAME(ifname)
+		NAME(encryption)
+		NAME(quality)
+	};
+	static const clas<Network>& structure() noexcept {
+		return O<Network,
+			P<Network, Name::ifname, symbol, &Network::ifname, interned>,
+			P<Network, Name::encryption, symbol, &Network::encryption,
+				interned>,
+			P<Network, Name::quality, signed char, &Network::quality>
+		>();
+	}
+};
+
+struct WiFi {
+	Network networks[4];
+	struct Name {
+		NAME(networks)
+	};
+	static const clas<WiFi>& structure() noexcept {
+		return O<WiFi,
+			P<WiFi, Name::networks, Network, countof(&WiFi::networks),
+				&WiFi::networks, Network::structure>
+		>();
+	}
+};
+
+struct Tag {
+	symbol kind;
+	struct Name {
+		NAME(kind)
+	};
+	static const clas<Tag>& structure() noexcept {
+		return O<Tag, P<Tag, Name::kind, symbol, &Tag::kind, limited>>();
+	}
+};
+
+static WiFi wifi;
+
+static result_t repeated(const Environment& env) noexcept {
+	names.clear();
+	wifi = WiFi();
+	details::source in(
+		"{\"networks\":["
+		"{\"ifname\":\"wlan0\",\"encryption\":\"psk2\",\"quality\":70},"
+		"{\"ifname\":\"wlan1\",\"encryption\":\"wpa\",\"quality\":50},"
+		"{\"ifname\":\"wlan0\",\"encryption\":\"psk2\",\"quality\":60},"
+		"{\"ifname\":\"wlan1\",\"encryption\":null,\"quality\":40}]}");
+	const Network* n = wifi.networks;
+	bool pass = WiFi::structure().read(wifi, in)
+		&& names.size() == 4
+		&& n[0].ifname == n[2].ifname && n[1].ifname == n[3].ifname
+		&& n[0].encryption == n[2].encryption
+		&& n[0].encryption == names.find("psk2")
+		&& n[1].encryption != n[0].encryption && n[3].encryption.null()
+		&& names.find("none").null();
+	pass = pass && WiFi::structure().write(wifi, env.output);
+	return combine1(pass, in.error() & ~error_t::eof, env.output.error());
+}
+
+static result_t preloaded(const Environment& env) noexcept {
+	names.clear();
+	symbol psk2 = names.intern("psk2");
+	Network net = {};
+	details::source in("{\"encryption\":\"psk2\",\"ifname\":\"eth0\"}");
+	bool pass = Network::structure().read(net, in)
+		&& net.encryption == psk2 && names.size() == 2;
+	pass = pass && Network::structure().write(net, env.output);
+	return combine1(pass, in.error() & ~error_t::eof, env.output.error());
+}
+
+static result_t exhausted(const Environment& env) noexcept {
+	few.clear();
+	Tag tags[3] = {};
+	details::source in("{\"kind\":\"a\"}");
+	bool pass = Tag::structure().read(tags[0], in);
+	in.set("{\"kind\":\"b\"}");
+	pass = pass && Tag::structure().read(tags[1], in);
+	in.set("{\"kind\":\"c\"}");
+	lexer lex(in);
+	pass = pass && Tag::structure().read(tags[2], lex)
+		&& tags[2].kind.null() && lex.error() == error_t::overrun
+		&& few.size() == 2;
+	pass = pass && Tag::structure().write(tags[2], env.output);
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test113(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test113 Test113::tests[] = {
+	RUN("interned: repeated values", {
+		return repeated(env);
+	}),
+	RUN("interned: preloaded pool", {
+		return preloaded(env);
+	}),
+	RUN("interned: pool is full", {
+		return exhausted(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11300)
+static cstring const Master[details::countof(Test113::tests)] = {
+	_P_(0), _P_(1), _P_(2)
+};
+#include "113.inc"
+
+cstring Test113::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 114.cpp - cojson tests, selecting values by JSON Pointer paths
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test114 : Test {
+	static Test114 tests[];
+	inline Test114(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+static cstring const document =
+	"{\"wan\":{\"ipaddr\":[\"10.0.0.2\",\"10.0.0.3\"],\"up\":true},"
+	"\"uptime\":1234,"
+	"\"wifinets\":[{\"networks\":[{\"ssid\":\"home\"},{\"ssid\":\"guest\"}]},"
+	"{\"name\":\"radio1\",\"networks\":[{\"ssid\":\"lab\",\"mode\":\"ap\"}]}],"
+	"\"a/b\":{\"m~n\":7},\"name\":\"router\"}";
+
+static char_t ipaddr[16];
+static long uptime;
+static int escaped;
+static view ssids[4];
+static unsigned found;
+
+static view none() noexcept { return view(); }
+static void add(view v) noexcept {
+	if( found < countof(ssids) ) ssids[found++] = v;
+}
+
+static result_t plain(const Environment& env) noexcept {
+	static const selector::path paths[] = {
+		{ "/wan/ipaddr/1",	V<countof(ipaddr), ipaddr> },
+		{ "/uptime",		V<long, &uptime> }
+	};
+	memset(ipaddr, 0, sizeof(ipaddr));
+	uptime = 0;
+	details::source in(document);
+	bool pass = selector(paths).read(in) && uptime == 1234
+		&& in.count() < strlen(document);
+	env.out(pass, "%s %ld\n", ipaddr, uptime);
+	pass = pass && V<countof(ipaddr), ipaddr>().write(env.output);
+	return combine1(pass, in.error(), env.output.error());
+}
+
+static result_t wildcards(const Environment& env) noexcept {
+	static const selector::path paths[] = {
+		{ "/wifinets/" "*" "/networks/" "*" "/ssid", V<view, none, add> },
+		{ "/a~1b/m~0n", V<int, &escaped> }
+	};
+	found = 0;
+	escaped = 0;
+	details::source in(document);
+	bool pass = selector(paths).read(in) && found == 3 && escaped == 7
+		&& ssids[0] == "home" && ssids[1] == "guest" && ssids[2] == "lab";
+	env.out(pass, "%d %.*s %.*s %.*s\n", escaped,
+		ssids[0].size(), ssids[0].data(), ssids[1].size(), ssids[1].data(),
+		ssids[2].size(), ssids[2].data());
+	pass = pass && details::writer<view>::write(ssids[1], env.output);
+	return combine1(pass, in.error() & ~error_t::eof, env.output.error());
+}
+
+static result_t missing(const Environment&) noexcept {
+	static const selector::path paths[] = {
+		{ "/uptime/days",	V<long, &uptime> },
+		{ "/wan/ipaddr/5",	V<countof(ipaddr), ipaddr> }
+	};
+	uptime = 0;
+	memset(ipaddr, 0, sizeof(ipaddr));
+	details::source in(document);
+	bool pass = selector(paths).read(in) && uptime == 0 && ipaddr[0] == 0
+		&& in.count() == strlen(document);
+	return combine1(pass, in.error() & ~error_t::eof);
+}
+
+/* paths that would read the same value, or one within another		*/
+static result_t overlapping(const Environment&) noexcept {
+	static const selector::path duplicate[] = {
+		{ "/uptime",		V<long, &uptime> },
+		{ "/uptime",		V<long, &uptime> }
+	};
+	static const selector::path nested[] = {
+		{ "/wan/ipaddr/0",	V<countof(ipaddr), ipaddr> },
+		{ "/wan/ipaddr",	V<view, none, add> }
+	};
+	static const selector::path wildcard[] = {
+		{ "/wifinets/1/name",	V<countof(ipaddr), ipaddr> },
+		{ "/wifinets/" "*" "/name",	V<view, none, add> }
+	};
+	static const selector::path distinct[] = {
+		{ "/wifinets/" "*" "/name",	V<view, none, add> },
+		{ "/wifinets/0/networks/0/ssid",	V<view, none, add> }
+	};
+	details::source in(document);
+	bool pass = ! selector(duplicate).read(in) && ! selector(nested).read(in)
+		&& ! selector(wildcard).read(in) && in.count() == 0
+		&& in.error() == details::error_t::bad;
+	details::source again(document);
+	found = 0;
+	pass = pass && selector(distinct).read(again) && found == 2
+		&& ssids[0] == "home" && ssids[1] == "radio1";
+	return combine1(pass);
+}
+
+static result_t malformed(const Environment&) noexcept {
+	static const selector::path zeros[] = {
+		{ "/wan/ipaddr/01",	V<countof(ipaddr), ipaddr> },
+		{ "/wifinets/00/networks/0/ssid",	V<view, none, add> }
+	};
+	static const selector::path tilde[] = {
+		{ "/a~1b/m~xn",		V<int, &escaped> }
+	};
+	static const selector::path trailing[] = {
+		{ "/a~1b/m~",		V<int, &escaped> }
+	};
+	memset(ipaddr, 0, sizeof(ipaddr));
+	found = 0;
+	details::source in(document);
+	bool pass = selector(zeros).read(in) && ipaddr[0] == 0 && found == 0;
+	escaped = 0;
+	details::source again(document);
+	pass = pass && ! selector(tilde).read(again)
+		&& ! selector(trailing).read(again) && again.count() == 0
+		&& again.error() == details::error_t::bad && escaped == 0;
+	return combine1(pass, in.error() & ~error_t::eof);
+}
+
+#define RUN(name, body) Test114(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test114 Test114::tests[] = {
+	RUN("selector: plain paths, stop early", {
+		return plain(env);
+	}),
+	RUN("selector: wildcards and escapes", {
+		return wildcards(env);
+	}),
+	RUN("selector: paths not in document", {
+		return missing(env);
+	}),
+	RUN("selector: overlapping paths", {
+		return overlapping(env);
+	}),
+	RUN("selector: malformed paths", {
+		return malformed(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11400)
+static cstring const Master[details::countof(Test114::tests)] = {
+	_P_(0), _P_(1), cstring(nullptr), cstring(nullptr),
+	cstring(nullptr)
+};
+#include "114.inc"
+
+cstring Test114::master() const noexcept {
+	return Master[index()];
+}
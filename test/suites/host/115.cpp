@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 115.cpp - cojson tests, schema-less token reader
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test115 : Test {
+	static Test115 tests[];
+	inline Test115(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+typedef details::tokens tokens;
+
+static bool text(const tokens::kind k, tokens& in, ostream& out) noexcept {
+	static const char codes[] = "{}[]ksnbxEX";
+	bool r = out.put(codes[static_cast<int>(k)]);
+	if( ! in.text().null() )
+		for(char_t c : in.text()) r = r && out.put(c);
+	else {
+		/* read in chunks, marking their boundaries					*/
+		char_t chunk[3];
+		unsigned n;
+		while( (n = in.read(chunk, countof(chunk))) != 0 ) {
+			r = r && out.put('|');
+			for(unsigned i = 0; i < n; ++i) r = r && out.put(chunk[i]);
+		}
+	}
+	if( k == tokens::kind::boolean )
+		r = r && out.put(in.boolean() ? 't' : 'f');
+	return r && out.put(' ');
+}
+
+/* writes all tokens of the input in short notation						*/
+static result_t dump(const Environment& env, lexer& lex) noexcept {
+	tokens in(lex);
+	tokens::kind k;
+	bool pass = true;
+	do pass = text(k = in.next(), in, env.output) && pass;
+	while( k != tokens::kind::end && k != tokens::kind::error );
+	return combine1(pass && k == tokens::kind::end,
+		lex.error() & ~error_t::eof, env.output.error());
+}
+
+static cstring const rpc =
+	"{\"jsonrpc\":\"2.0\",\"params\":{\"id\":7,\"list\":[1,-2.5e3,true,"
+	"false,null,[]],\"s\":\"a\\\"b\"},\"method\":\"reboot\",\"tail\":{}}";
+
+static result_t windowed(const Environment& env) noexcept {
+	details::source in(rpc);
+	lexer lex(in);
+	return dump(env, lex);
+}
+
+static result_t chunked(const Environment& env) noexcept {
+	return dump(env, json(rpc));
+}
+
+/* finds the method name, skipping params								*/
+static result_t method(const Environment& env) noexcept {
+	details::source in(rpc);
+	lexer lex(in);
+	tokens t(lex);
+	bool pass = t.next() == tokens::kind::begin_object;
+	long id = 0;
+	view name;
+	tokens::kind k;
+	while( pass && (k = t.next()) == tokens::kind::key ) {
+		if( t.text() == "method" ) {
+			pass = t.next() == tokens::kind::string;
+			name = t.text();
+			break;
+		}
+		k = t.next();
+		if( k == tokens::kind::begin_object || k == tokens::kind::begin_array )
+			pass = t.skip();
+	}
+	pass = pass && name == "reboot" && t.depth() == 1;
+	t.skip();
+	pass = pass && t.next() == tokens::kind::end;
+	details::source num("[12345]");
+	lexer nlex(num);
+	tokens n(nlex);
+	pass = pass && n.next() == tokens::kind::begin_array
+		&& n.next() == tokens::kind::number && n.as(id) && id == 12345;
+	pass = pass && details::writer<view>::write(name, env.output);
+	return combine1(pass, env.output.error());
+}
+
+static result_t malformed(const Environment&) noexcept {
+	details::source in("{\"a\" 1}");
+	lexer lex(in);
+	tokens t(lex);
+	bool pass = t.next() == tokens::kind::begin_object
+		&& t.next() == tokens::kind::key && t.next() == tokens::kind::error
+		&& t.next() == tokens::kind::error;
+	return combine1(pass);
+}
+
+#define RUN(name, body) Test115(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test115 Test115::tests[] = {
+	RUN("tokens: views into the window", {
+		return windowed(env);
+	}),
+	RUN("tokens: chunked strings", {
+		return chunked(env);
+	}),
+	RUN("tokens: routing by method", {
+		return method(env);
+	}),
+	RUN("tokens: malformed input", {
+		return malformed(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11500)
+static cstring const Master[details::countof(Test115::tests)] = {
+	_P_(0), _P_(1), _P_(2), cstring(nullptr)
+};
+#include "115.inc"
+
+cstring Test115::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 116.cpp - cojson tests, tape of a document
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test116 : Test {
+	static Test116 tests[];
+	inline Test116(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+typedef details::tape tape;
+
+static cstring const rpc =
+	"{\"jsonrpc\":\"2.0\",\"params\":{\"id\":7,\"list\":[1,-2.5e3,true,"
+	"false,null,[]],\"s\":\"a\\\"b\"},\"method\":\"reboot\",\"tail\":{}}";
+
+/* writes cells in short notation: kind, offset and size or end		*/
+static result_t listing(const Environment& env) noexcept {
+	static const char codes[] = "{[ksirbx";
+	tape::cell data[32];
+	tape t(data);
+	bool pass = t.parse(rpc);
+	for(const tape::cell& c : t) {
+		pass = pass && env.output.put(codes[static_cast<int>(c.type)]) &&
+			details::writer<unsigned>::write(c.at, env.output) &&
+			env.output.put(':') &&
+			details::writer<unsigned>::write(c.size, env.output);
+		if( c.type == tape::kind::object || c.type == tape::kind::array )
+			pass = pass && env.output.put('>') &&
+				details::writer<unsigned>::write(c.end, env.output);
+		pass = pass && env.output.put(' ');
+	}
+	return combine1(pass, t.error(), env.output.error());
+}
+
+static result_t rewrite(const Environment& env) noexcept {
+	tape::cell data[32];
+	tape t(data);
+	bool pass = t.parse(" [ {\"a\" : [ ] } ,\t-0.5 , \"\\u0041\" ] ");
+	pass = pass && t.write(env.output);
+	return combine1(pass, t.error(), env.output.error());
+}
+
+/* random access by names and positions									*/
+static result_t access(const Environment& env) noexcept {
+	tape::cell data[32];
+	tape t(data);
+	char_t s[8];
+	bool pass = t.parse(rpc);
+	const unsigned params = t.find(0, "params");
+	const unsigned list = t.find(params, "list");
+	pass = pass && params != tape::none && list != tape::none
+		&& t[list].size == 6 && t[t.item(list, 0)].integer == 1
+		&& t[t.item(list, 1)].type == tape::kind::real
+		&& t[t.item(list, 1)].real < -2499.9
+		&& t[t.item(list, 1)].real > -2500.1
+		&& t[t.item(list, 2)].boolean
+		&& t[t.item(list, 4)].type == tape::kind::null
+		&& t.item(list, 6) == tape::none
+		&& t.find(0, "missing") == tape::none
+		&& t.item(0, 3) == t.find(0, "tail")
+		&& t.read(t.find(params, "s"), s, countof(s))
+		&& strcmp(s, "a\"b") == 0
+		&& ! t.read(t.find(0, "method"), s, 4);
+	pass = pass && t.write(env.output, params);
+	return combine1(pass, t.error(), env.output.error());
+}
+
+static result_t malformed(const Environment&) noexcept {
+	tape::cell data[4];
+	tape t(data);
+	bool pass =
+		! t.parse("{\"a\" 1}") && t.error() == error_t::bad &&
+		! t.parse("[1,2") && t.error() == error_t::eof &&
+		! t.parse("[1] 2") && t.error() == error_t::bad &&
+		! t.parse("[1,2,3,4]") && t.error() == error_t::overrun &&
+		! t.parse("[tru]") && t.error() == error_t::bad &&
+		t.parse("[1,2,3]") && t.size() == 4;
+	return combine1(pass);
+}
+
+/* keys are matched decoded, with escapes resolved						*/
+static result_t escaped(const Environment&) noexcept {
+	tape::cell data[8];
+	tape t(data);
+	bool pass = t.parse("{\"a\\\"b\":1,\"\\u0063d\":2,\"e\\\\\":3}");
+	const unsigned ab = t.find(0, "a\"b");
+	const unsigned cd = t.find(0, "cd");
+	const unsigned e = t.find(0, "e\\");
+	pass = pass && ab != tape::none && cd != tape::none && e != tape::none
+		&& t[ab].integer == 1 && t[cd].integer == 2 && t[e].integer == 3
+		&& t.find(0, "a") == tape::none
+		&& t.find(0, "a\"bc") == tape::none
+		&& t.find(0, "\\u0063d") == tape::none;
+	return combine1(pass, t.error());
+}
+
+#define RUN(name, body) Test116(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test116 Test116::tests[] = {
+	RUN("tape: cells", {
+		return listing(env);
+	}),
+	RUN("tape: writing back", {
+		return rewrite(env);
+	}),
+	RUN("tape: random access", {
+		return access(env);
+	}),
+	RUN("tape: malformed input", {
+		return malformed(env);
+	}),
+	RUN("tape: escaped keys", {
+		return escaped(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11600)
+static cstring const Master[details::countof(Test116::tests)] = {
+	_P_(0), _P_(1), _P_(2), cstring(nullptr), cstring(nullptr)
+};
+#include "116.inc"
+
+cstring Test116::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 117.cpp - cojson tests, newline delimited JSON
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test117 : Test {
+	static Test117 tests[];
+	inline Test117(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Entry {
+	int level;
+	char_t msg[8];
+	struct Name {
+		NAME(level)
+		NAME(msg)
+	};
+	static const clas<Entry>& structure() noexcept {
+		return O<Entry,
+			P<Entry, Name::level, int, &Entry::level>,
+			P<Entry, Name::msg, countof(&Entry::msg), &Entry::msg>
+		>();
+	}
+};
+
+static cstring const feed =
+	"\xEF\xBB\xBF{\"level\":1,\"msg\":\"boot\"}\n"
+	"\n"
+	"{\"level\":2,\"msg\":\"link up\"}\r\n"
+	"{\"level\":x,\"msg\":\"lost\"}\n"
+	"{\"level\":4,\"msg\":\"too long msg\"}\n"
+	"{\"level\":5}{\"level\":6}\n"
+	"  {\"msg\":\"idle\",\"level\":7}  \n"
+	"{\"level\":8,\"msg\":\"eof";
+
+/* writes records read and the counters									*/
+static result_t scan(const Environment& env, istream& in) noexcept {
+	details::records<Entry> input(in, Entry::structure());
+	Entry entry;
+	bool pass = true;
+	while( input.read(entry) ) {
+		pass = pass && details::writer<int>::write(entry.level, env.output) &&
+			env.output.put(':') && env.output.puts(entry.msg) &&
+			env.output.put(' ');
+		entry.msg[0] = 0;
+	}
+	pass = pass && details::writer<unsigned>::write(
+		static_cast<unsigned>(input.count()), env.output) &&
+		env.output.put('/') && details::writer<unsigned>::write(
+		static_cast<unsigned>(input.failures()), env.output) &&
+		env.output.put('/') && details::writer<unsigned>::write(
+		static_cast<unsigned>(input.characters()), env.output);
+	return combine1(pass, env.output.error());
+}
+
+static result_t windowed(const Environment& env) noexcept {
+	details::source in(feed);
+	return scan(env, in);
+}
+
+static result_t chunked(const Environment& env) noexcept {
+	cstream in(feed);
+	return scan(env, in);
+}
+
+static result_t logging(const Environment& env) noexcept {
+	details::journal<Entry> output(env.output, Entry::structure());
+	Entry entry { 1, "boot" };
+	bool pass = output.write(entry);
+	entry.level = -2;
+	strcpy(entry.msg, "a\"b");
+	pass = pass && output.write(entry) && output.count() == 2
+		&& output.failures() == 0 && output.characters() == 51;
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test117(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test117 Test117::tests[] = {
+	RUN("records: windowed input", {
+		return windowed(env);
+	}),
+	RUN("records: chunked input", {
+		return chunked(env);
+	}),
+	RUN("journal: writing records", {
+		return logging(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11700)
+static cstring const Master[details::countof(Test117::tests)] = {
+	_P_(0), _P_(1), _P_(2)
+};
+#include "117.inc"
+
+cstring Test117::master() const noexcept {
+	return Master[index()];
+}
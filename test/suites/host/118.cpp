@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 118.cpp - cojson tests, parallel reading of records
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <stdio.h>
+#include "cojson_parallel.hpp"
+#include "test.hpp"
+
+struct Test118 : Test {
+	static Test118 tests[];
+	inline Test118(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Line {
+	int level;
+	short code;
+	struct Name {
+		NAME(level)
+		NAME(code)
+	};
+	static const clas<Line>& structure() noexcept {
+		return O<Line,
+			P<Line, Name::level, int, &Line::level>,
+			P<Line, Name::code, short, &Line::code>
+		>();
+	}
+};
+
+static char_t ledger[16384];
+
+/* fills ledger with lines of uneven length, every 10th malformed		*/
+static unsigned fill() noexcept {
+	unsigned n = 0;
+	for(int i = 0; i < 300; ++i) {
+		if( i % 10 == 9 )
+			n += sprintf(ledger + n, "{\"level\":%d,\"code\":}\n", i);
+		else
+			n += sprintf(ledger + n, "%*s{\"level\":%d,\"code\":%d}\n",
+				i % 23, "", i, i % 7);
+	}
+	return n;
+}
+
+static result_t spread(const Environment& env, unsigned workers,
+		unsigned chunk) noexcept {
+	const unsigned size = fill();
+	std::vector<std::vector<Line>> found(workers);
+	std::atomic<unsigned> order(0);
+	std::vector<std::atomic<unsigned>> seen(countof(ledger) / chunk + 1);
+	const parallel::totals t = parallel::records(ledger, size,
+		Line::structure(), [&](unsigned w, std::size_t k, const Line& l) {
+			found[w].push_back(l);
+			if( seen[k]++ == 0 ) ++order;
+		}, workers, chunk);
+	long sum = 0;
+	unsigned count = 0;
+	for(const auto& v : found)
+		for(const Line& l : v) {
+			sum += l.level;
+			++count;
+		}
+	bool pass = count == t.records && t.characters == size
+		&& order <= (size + chunk - 1) / chunk;
+	char_t out[64];
+	sprintf(out, "%lu/%lu/%ld", t.records, t.failures, sum);
+	pass = pass && env.output.puts(out);
+	return combine1(pass, env.output.error());
+}
+
+/* members missing in a record are not carried over from the previous	*/
+static result_t reset(const Environment& env) noexcept {
+	static const char_t text[] =
+		"{\"level\":1,\"code\":9}\n{\"level\":2}\n{\"code\":5}\n";
+	std::vector<Line> found;
+	const parallel::totals t = parallel::records(text, countof(text) - 1,
+		Line::structure(), [&](unsigned, std::size_t, const Line& l) {
+			found.push_back(l);
+		}, 1);
+	bool pass = t.records == 3 && found.size() == 3;
+	char_t out[16];
+	for(const Line& l : found) {
+		sprintf(out, "%d:%d ", l.level, l.code);
+		pass = pass && env.output.puts(out);
+	}
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test118(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test118 Test118::tests[] = {
+	RUN("parallel: single worker", {
+		return spread(env, 1, 65536);
+	}),
+	RUN("parallel: small chunks", {
+		return spread(env, 4, 100);
+	}),
+	RUN("parallel: chunks shorter than lines", {
+		return spread(env, 3, 7);
+	}),
+	RUN("parallel: records start afresh", {
+		return reset(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11800)
+static cstring const Master[details::countof(Test118::tests)] = {
+	_P_(0), _P_(1), _P_(2), _P_(3)
+};
+#include "118.inc"
+
+cstring Test118::master() const noexcept {
+	return Master[index()];
+}
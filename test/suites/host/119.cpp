@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 119.cpp - cojson tests, parallel reading of a top level array
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <stdio.h>
+#include "cojson_parallel.hpp"
+#include "test.hpp"
+
+struct Test119 : Test {
+	static Test119 tests[];
+	inline Test119(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Item {
+	int id;
+	char_t tag[8];
+	int pair[2];
+	struct Name {
+		NAME(id)
+		NAME(tag)
+		NAME(pair)
+	};
+	static const clas<Item>& structure() noexcept {
+		return O<Item,
+			P<Item, Name::id, int, &Item::id>,
+			P<Item, Name::tag, countof(&Item::tag), &Item::tag>,
+			P<Item, Name::pair, int, countof(&Item::pair), &Item::pair>
+		>();
+	}
+};
+
+static char_t exported[32768];
+
+/* fills exported with an array of n items, with strings and nesting
+ * that the structural pass must step over								*/
+static unsigned fill(unsigned n) noexcept {
+	unsigned len = sprintf(exported, " [\n");
+	for(unsigned i = 0; i < n; ++i)
+		len += sprintf(exported + len, "%s {\"id\":%u,\"tag\":\"%s\","
+			"\"pair\":[%u,%u]}", i ? ",\n" : "", i,
+			i % 3 == 0 ? "a,]\\\"" : i % 3 == 1 ? "[{" : "}", i, i % 5);
+	len += sprintf(exported + len, "\n] ");
+	return len;
+}
+
+/* writes counters and whether items are in the original order			*/
+static bool report(const Environment& env, const parallel::totals& t,
+		const Item* items, unsigned n) noexcept {
+	bool ordered = true;
+	for(unsigned i = 0; i < n; ++i)
+		ordered = ordered && items[i].id == static_cast<int>(i) &&
+			items[i].pair[0] == items[i].id && items[i].pair[1] == static_cast<int>(i % 5);
+	char_t out[64];
+	sprintf(out, "%lu/%lu/%s/%s", t.records, t.failures,
+		ordered ? "ordered" : "shuffled", n ? items[n - 1].tag : "-");
+	return env.output.puts(out);
+}
+
+static result_t growable(const Environment& env) noexcept {
+	const unsigned size = fill(500);
+	std::vector<Item> items;
+	const parallel::totals t = parallel::items(exported, size,
+		Item::structure(), items, 4, 16);
+	bool pass = items.size() == 500 && report(env, t, items.data(), 500);
+	return combine1(pass, env.output.error());
+}
+
+static result_t preallocated(const Environment& env) noexcept {
+	static Item items[300];
+	const unsigned size = fill(301);
+	std::size_t count;
+	const parallel::totals t = parallel::items(exported, size,
+		Item::structure(), items, countof(items), count, 3, 7);
+	bool pass = count == 301 && report(env, t, items, countof(items));
+	return combine1(pass, env.output.error());
+}
+
+static result_t malformed(const Environment& env) noexcept {
+	static cstring const inputs[] = {
+		" [ ] ", "[{\"id\":1},{\"id\":x},{\"id\":3}]", "{\"id\":1}",
+		"[{\"id\":1}", "[{\"id\":1},,{\"id\":3}]", "[{\"id\":1},]", "[,]"
+	};
+	bool pass = true;
+	for(cstring in : inputs) {
+		std::vector<Item> items;
+		const parallel::totals t = parallel::items(in, strlen(in),
+			Item::structure(), items, 2, 1);
+		char_t out[32];
+		sprintf(out, "%u:%lu/%lu ", static_cast<unsigned>(items.size()),
+			t.records, t.failures);
+		pass = env.output.puts(out) && pass;
+	}
+	return combine1(pass, env.output.error());
+}
+
+/* malformed elements and ones followed by junk come back default		*/
+static result_t defaults(const Environment& env) noexcept {
+	static cstring const in = "[{\"id\":1},{\"id\":7,\"pair\":[1,x]},"
+		"{\"id\":4,\"tag\":\"t\"} 5,{\"id\":3}]";
+	static Item fixed[4];
+	std::vector<Item> items;
+	std::size_t count;
+	for(Item& item : fixed) item = Item{ 99, "junk", { 9, 9 } };
+	const parallel::totals t = parallel::items(in, strlen(in),
+		Item::structure(), items, 2, 1);
+	const parallel::totals f = parallel::items(in, strlen(in),
+		Item::structure(), fixed, countof(fixed), count, 2, 1);
+	/* absent members of elements read keep what was there before		*/
+	bool pass = items.size() == 4 && count == 4 && fixed[0].id == 1
+		&& fixed[3].id == 3 && fixed[3].pair[0] == 9;
+	for(unsigned i = 1; pass && i < 3; ++i)
+		pass = fixed[i].id == 0 && fixed[i].tag[0] == 0 &&
+			fixed[i].pair[0] == 0 && fixed[i].pair[1] == 0;
+	char_t out[64];
+	for(unsigned i = 0; pass && i < 4; ++i) {
+		sprintf(out, "%d:%s:%d ", items[i].id, items[i].tag,
+			items[i].pair[0] + items[i].pair[1]);
+		pass = env.output.puts(out);
+	}
+	sprintf(out, "%lu/%lu %lu/%lu", t.records, t.failures,
+		f.records, f.failures);
+	pass = pass && env.output.puts(out);
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test119(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test119 Test119::tests[] = {
+	RUN("parallel: array into a vector", {
+		return growable(env);
+	}),
+	RUN("parallel: array into a preallocated array", {
+		return preallocated(env);
+	}),
+	RUN("parallel: malformed arrays", {
+		return malformed(env);
+	}),
+	RUN("parallel: failed elements default constructed", {
+		return defaults(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (11900)
+static cstring const Master[details::countof(Test119::tests)] = {
+	_P_(0), _P_(1), _P_(2), _P_(3)
+};
+#include "119.inc"
+
+cstring Test119::master() const noexcept {
+	return Master[index()];
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 120.cpp - cojson tests, parallel writing of an array
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "cojson_parallel.hpp"
+#include "test.hpp"
+
+struct Test120 : Test {
+	static Test120 tests[];
+	inline Test120(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Sample {
+	int id;
+	double value;
+	char_t tag[8];
+	struct Name {
+		NAME(id)
+		NAME(value)
+		NAME(tag)
+	};
+	static const clas<Sample>& structure() noexcept {
+		return O<Sample,
+			P<Sample, Name::id, int, &Sample::id>,
+			P<Sample, Name::value, double, &Sample::value>,
+			P<Sample, Name::tag, countof(&Sample::tag), &Sample::tag>
+		>();
+	}
+};
+
+static constexpr unsigned total = 1000;
+
+struct Batch {
+	Sample samples[total];
+	struct Name {
+		NAME(samples)
+	};
+	static const clas<Batch>& structure() noexcept {
+		return O<Batch,
+			P<Batch, Name::samples, Sample, total, &Batch::samples,
+				Sample::structure>
+		>();
+	}
+};
+
+static Batch batch;
+static char_t serial[65536];
+static char_t parallel_[65536];
+
+/* writes batch serially, returns the array part of the output			*/
+static view reference() noexcept {
+	for(unsigned i = 0; i < total; ++i) {
+		batch.samples[i].id = i;
+		batch.samples[i].value = i * 0.25 - 7;
+		sprintf(batch.samples[i].tag, i % 4 ? "t%u" : "q\"%u", i % 100);
+	}
+	details::buffer out(serial);
+	Batch::structure().write(batch, out);
+	static constexpr unsigned prefix = sizeof("{\"samples\":") - 1;
+	return view(serial + prefix, out.count() - prefix - 1);
+}
+
+static result_t identical(const Environment& env, unsigned n,
+		unsigned workers, unsigned slice) noexcept {
+	const view expected = reference();
+	details::buffer out(parallel_);
+	bool pass = parallel::write(batch.samples, n, Sample::structure(), out,
+		workers, slice);
+	pass = pass && (n == total ?
+		out.count() == expected.size() &&
+			memcmp(parallel_, expected.data(), out.count()) == 0 :
+		env.output.write(parallel_, out.count()));
+	return combine1(pass, env.output.error());
+}
+
+/* sink failing at the n-th slice stops writing							*/
+static result_t failing(const Environment&) noexcept {
+	reference();
+	unsigned calls = 0;
+	bool pass = ! parallel::gather(batch.samples, total, Sample::structure(),
+		[&calls](const char_t*, std::size_t) { return ++calls < 3; }, 4, 10)
+		&& calls == 3;
+	return combine1(pass);
+}
+
+#define RUN(name, body) Test120(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test120 Test120::tests[] = {
+	RUN("parallel: writing identical to serial", {
+		return identical(env, total, 4, 37);
+	}),
+	RUN("parallel: writing with a single worker", {
+		return identical(env, total, 1, 256);
+	}),
+	RUN("parallel: writing few items", {
+		return identical(env, 3, 8, 1);
+	}),
+	RUN("parallel: writing nothing", {
+		return identical(env, 0, 2, 5);
+	}),
+	RUN("parallel: failing sink", {
+		return failing(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (12000)
+static cstring const Master[details::countof(Test120::tests)] = {
+	cstring(nullptr), cstring(nullptr), _P_(2), _P_(3), cstring(nullptr)
+};
+#include "120.inc"
+
+cstring Test120::master() const noexcept {
+	return Master[index()];
+}
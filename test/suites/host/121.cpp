@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 121.cpp - cojson tests, member name prologs
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test121 : Test {
+	static Test121 tests[];
+	inline Test121(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Gauge {
+	int id;
+	bool on;
+	char_t tag[8];
+	struct Name {
+		NAME(id)
+		NAME(on)
+		NAME(tag)
+		/* names that need escaping are never prebuilt					*/
+		static inline constexpr const char_t* quote() noexcept {
+			return "q\"t";
+		}
+		static inline constexpr const char_t* tab() noexcept {
+			return "\t";
+		}
+	};
+	static const clas<Gauge>& plain() noexcept {
+		return O<Gauge,
+			P<Gauge, Name::id, int, &Gauge::id>,
+			P<Gauge, Name::on, bool, &Gauge::on>,
+			P<Gauge, Name::tag, countof(&Gauge::tag), &Gauge::tag>
+		>();
+	}
+	static const clas<Gauge>& mixed() noexcept {
+		return O<Gauge,
+			P<Gauge, Name::quote, int, &Gauge::id>,
+			P<Gauge, Name::on, bool, &Gauge::on>,
+			P<Gauge, Name::tab, countof(&Gauge::tag), &Gauge::tag>
+		>();
+	}
+};
+
+static int width = 3;
+static int height = -4;
+
+struct Dims {
+	NAME(width)
+	NAME(height)
+	static inline constexpr const char_t* slash() noexcept {
+		return "w/h";
+	}
+};
+
+static const value& dims() noexcept {
+	return V<
+		M<Dims::width, int, &width>,
+		M<Dims::slash, int, &height>,
+		M<Dims::height, int, &height>
+	>();
+}
+
+static result_t writing(const Environment& env,
+		const clas<Gauge>& structure) noexcept {
+	Gauge gauge { 12, true, "x" };
+	bool pass = structure.write(gauge, env.output);
+	return combine1(pass, env.output.error());
+}
+
+/* fragments are built only if configured and only for verbatim names	*/
+static result_t fragments(const Environment&) noexcept {
+	static constexpr bool prebuilt =
+		config::names == config::names_is::prebuilt;
+	const details::fragment id(details::prefix<Gauge::Name::id>::get());
+	bool pass =
+		details::prefix<Gauge::Name::quote>::get().empty() &&
+		details::prefix<Gauge::Name::tab>::get().empty() &&
+		id.empty() == ! prebuilt &&
+		( ! prebuilt || ( id.len == 6 &&
+			memcmp(id.str, ",\"id\":", id.len) == 0 ) );
+	return combine1(pass);
+}
+
+#define RUN(name, body) Test121(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test121 Test121::tests[] = {
+	RUN("names: verbatim members", {
+		return writing(env, Gauge::plain());
+	}),
+	RUN("names: members needing escapes", {
+		return writing(env, Gauge::mixed());
+	}),
+	RUN("names: variables", {
+		bool pass = dims().write(env.output);
+		return combine1(pass, env.output.error());
+	}),
+	RUN("names: fragments", {
+		return fragments(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (12100)
+static cstring const Master[details::countof(Test121::tests)] = {
+	_P_(0), _P_(1), _P_(2), cstring(nullptr)
+};
+#include "121.inc"
+
+cstring Test121::master() const noexcept {
+	return Master[index()];
+}
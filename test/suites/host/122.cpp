@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2015 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * 122.cpp - cojson tests, precompiled output outlines
+ *
+ * This file is part of COJSON Library. http://hutorny.in.ua/projects/cojson
+ *
+ * The COJSON Library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License v2
+ * as published by the Free Software Foundation;
+ *
+ * The COJSON Library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with the COJSON Library; if not, see
+ * <http://www.gnu.org/licenses/gpl-2.0.html>.
+ */
+
+#include <string.h>
+#include "test.hpp"
+
+struct Test122 : Test {
+	static Test122 tests[];
+	inline Test122(cstring name, cstring desc, runner func)
+		noexcept : Test(name, desc, func) {}
+	int index() const noexcept {
+		return (this-tests);
+	}
+	cstring master() const noexcept;
+};
+
+struct Pos {
+	short x;
+	short y;
+	struct Name {
+		NAME(x)
+		NAME(y)
+	};
+	static const clas<Pos>& structure() noexcept {
+		return O<Pos,
+			P<Pos, Name::x, short, &Pos::x>,
+			P<Pos, Name::y, short, &Pos::y>
+		>();
+	}
+};
+
+/* object with a nested object										*/
+struct Sensor {
+	int id;
+	Pos pos;
+	char_t name[8];
+	bool on;
+	struct Name {
+		NAME(id)
+		NAME(pos)
+		NAME(name)
+		NAME(on)
+	};
+	static const clas<Sensor>& structure() noexcept {
+		return O<Sensor,
+			P<Sensor, Name::id, int, &Sensor::id>,
+			P<Sensor, Name::pos, Pos, &Sensor::pos, Pos::structure>,
+			P<Sensor, Name::name, countof(&Sensor::name), &Sensor::name>,
+			P<Sensor, Name::on, bool, &Sensor::on>
+		>();
+	}
+};
+
+/* object with an array of scalars and an array of objects			*/
+struct Route {
+	long id;
+	int hops[3];
+	Pos stops[2];
+	struct Name {
+		NAME(id)
+		NAME(hops)
+		NAME(stops)
+	};
+	static const clas<Route>& structure() noexcept {
+		return O<Route,
+			P<Route, Name::id, long, &Route::id>,
+			P<Route, Name::hops, int, countof(&Route::hops), &Route::hops>,
+			P<Route, Name::stops, Pos, countof(&Route::stops), &Route::stops,
+				Pos::structure>
+		>();
+	}
+};
+
+static char_t serial[256];
+static char_t outlined[256];
+
+/* writes obj with outline o and with the structure, compares the output
+ * byte for byte and passes it to the environment					*/
+template<class C, class O>
+static bool same(const Environment& env, O& o, const C& obj) noexcept {
+	details::buffer a(serial), b(outlined);
+	bool pass = C::structure().write(obj, a) && o.write(obj, b) &&
+		a.count() == b.count() && memcmp(serial, outlined, a.count()) == 0;
+	return pass && env.output.write(outlined, b.count());
+}
+
+static result_t nested(const Environment& env) noexcept {
+	static const Sensor first = { 1, { -3, 4 }, "north", true };
+	static const Sensor second = { -20, { 7, -8 }, "s\"th", false };
+	static details::outline<Sensor, 8, 64> o(Sensor::structure());
+	bool pass = same(env, o, first) && o.compiled() &&
+		env.output.put(' ') && same(env, o, second);
+	return combine1(pass, env.output.error());
+}
+
+static result_t arrays(const Environment& env) noexcept {
+	static const Route first = { 100000L, { 1, 2, 3 }, { { 1, 2 }, { 3, 4 } } };
+	static const Route second = { -7, { -1, 0, 9 }, { { 5, 6 }, { -7, 8 } } };
+	static details::outline<Route, 16, 96> o(Route::structure());
+	bool pass = same(env, o, first) && o.compiled() &&
+		env.output.put(' ') && same(env, o, second);
+	return combine1(pass, env.output.error());
+}
+
+/* outline too small for the object falls back to the structure		*/
+static result_t fallback(const Environment& env) noexcept {
+	static const Route route = { 3, { 4, 5, 6 }, { { 7, 8 }, { 9, 10 } } };
+	static details::outline<Route, 2, 16> o(Route::structure());
+	bool pass = same(env, o, route) && ! o.compiled() && o.failed();
+	return combine1(pass, env.output.error());
+}
+
+#define RUN(name, body) Test122(__FILE__,name, \
+		[](const Environment& env) noexcept -> result_t body)
+Test122 Test122::tests[] = {
+	RUN("outline: nested object", {
+		return nested(env);
+	}),
+	RUN("outline: arrays of scalars and objects", {
+		return arrays(env);
+	}),
+	RUN("outline: too small, falls back", {
+		return fallback(env);
+	}),
+};
+
+#undef  _T_
+#define _T_ (12200)
+static cstring const Master[details::countof(Test122::tests)] = {
+	_P_(0), _P_(1), _P_(2)
+};
+#include "122.inc"
+
+cstring Test122::master() const noexcept {
+	return Master[index()];
+}